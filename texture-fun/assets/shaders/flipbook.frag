@@ -0,0 +1,16 @@
+#version 150
+
+out vec4 outColor;
+
+in vec2 TexCoord;
+flat in float Layer;
+
+uniform sampler2DArray ourTextures;
+
+void main() {
+    vec4 finalColor = texture(ourTextures, vec3(TexCoord, Layer));
+    if (finalColor.a < 0.1) {
+        discard;
+    }
+    outColor = finalColor;
+}
@@ -0,0 +1,22 @@
+#version 330
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texcoord;
+
+// 每個 instance 一份，由 QuadRenderer 寫入 instance VBO
+layout (location = 2) in mat4 model;
+layout (location = 6) in float layer;
+
+out vec2 TexCoord;
+flat out float Layer;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+};
+
+void main() {
+    TexCoord = texcoord;
+    Layer = layer;
+    gl_Position = projection * view * model * vec4(position, 1.0);
+}
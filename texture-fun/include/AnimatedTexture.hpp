@@ -0,0 +1,104 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "MPSCQueue.hpp"
+#include "PixelUploader.hpp"
+#include "Texture.hpp"
+#include "ThreadPool.hpp"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct stbi_gif_stream;
+
+// 以串流的方式播放 GIF：影格數與每張影格的延遲時間直接從檔案讀出，
+// 影格依照播放時間逐張解碼（delta compositing 由 stb_image 處理）並以 glTexSubImage2D 更新同一張貼圖。
+// 記憶體中只保留壓縮過的檔案以及播放位置附近的少數幾張影格，動畫再長也不會變多。
+// 解碼在 ThreadPool 上進行（同一時間只有一個工作在跑，因為 GIF 只能依序解碼），
+// 主執行緒只上傳真正要顯示的影格，CPU mipmap 也只替這一張產生。只能在擁有 GL context 的執行緒上使用。
+// 每張影格在自己的 PBO ring 中有一段 staging：persistent mapping 時 worker 把翻轉後的 canvas 直接寫進去，
+// mip chain 也在同一段空間裡逐層縮小，像素不會先經過一塊 client memory。
+struct AnimatedTexture {
+    unsigned int id;
+    int width;
+    int height;
+    int frames;
+
+    // 每張影格的顯示時間（毫秒）
+    std::vector<int> delays;
+
+    // 第一張影格在建構時同步解碼並上傳，之後的影格都交給 pool
+    AnimatedTexture(ThreadPool& pool, const std::string& filename, const TextureOptions& options = TextureOptions(), int lookahead = 4);
+    ~AnimatedTexture();
+
+    AnimatedTexture(const AnimatedTexture&) = delete;
+    AnimatedTexture& operator=(const AnimatedTexture&) = delete;
+
+    // 依照播放時間（秒）切換到對應的影格，超過總長度時會循環播放。
+    // 目標影格還沒解碼好時繼續顯示目前的影格，不會在這裡等待
+    void Update(float time);
+    void Bind();
+
+    int CurrentFrame() const;
+    float Duration() const;
+
+private:
+    struct Frame {
+        // -1 代表解碼失敗
+        int index = -1;
+        // 已經上下翻轉過的 RGBA level 0，寫在 staging 或 pixels 其中之一
+        PixelUploader::Staging staging;
+        std::vector<unsigned char> pixels;
+    };
+
+    struct Level {
+        int width;
+        int height;
+        // 在一張影格的 staging 中的位置
+        std::size_t offset;
+    };
+
+    int FrameAt(float time) const;
+    // 在 pool 上解碼下一張影格；wanted 不是 -1 時一路解碼到那一張為止，中間的影格只做 compositing
+    void DecodeAsync(int wanted);
+    bool DecodeNext(int wanted, Frame& frame);
+    void Upload(const Frame& frame);
+    void GenerateMipmaps(const Frame& frame, const PixelUploader::Staging& staging);
+    void Recycle(Frame& frame);
+
+    ThreadPool& m_pool;
+    TextureOptions m_options;
+    std::size_t m_lookahead;
+
+    // 以下三個只有正在執行的解碼工作會用到
+    std::vector<unsigned char> m_file;
+    stbi_gif_stream* m_stream;
+    int m_next_index;
+
+    MPSCQueue<Frame> m_completed;
+    bool m_decoding;
+    bool m_failed;
+    // 顯示過或被跳過的影格留下來的記憶體，下一次解碼時重複使用
+    std::vector<std::vector<unsigned char>> m_free_pixels;
+    // 不經過 ring 或 ring 不能讀回時，CPU mipmap 的 level 1 以後寫在這裡，每次上傳都重複使用同一塊
+    std::vector<unsigned char> m_mips;
+
+    // 只給這張動畫使用的 ring，大小剛好容納 lookahead + 2 張影格（含 mip chain），
+    // 所以還在等待顯示的影格不會被其他上傳覆蓋
+    std::vector<Level> m_levels;
+    std::size_t m_frame_bytes;
+    std::unique_ptr<PixelUploader> m_uploader;
+
+    // m_start_times[i] 為第 i 張影格開始的時間，最後一個元素為整段動畫的長度（毫秒）
+    std::vector<long long> m_start_times;
+
+    // 已解碼但還沒顯示的影格，依播放順序排列
+    std::deque<Frame> m_decoded;
+    int m_current;
+};
+
+// 一次解碼 GIF 的所有影格（已經上下翻轉的 RGBA），給 TextureArray 使用；delays 為每張影格的顯示時間（毫秒），
+// 規則與 AnimatedTexture 相同。記憶體用量與影格數成正比，長動畫應該改用 AnimatedTexture 串流播放
+bool LoadGifFrames(const std::string& filename, std::vector<Image>& images, std::vector<int>& delays);
\ No newline at end of file
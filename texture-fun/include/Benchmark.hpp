@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Camera.hpp"
+
+// 每個 frame 的時間統計（毫秒），第一個 frame 包含了載入的時間，預設不列入
+struct FrameStats {
+    std::size_t count = 0;
+    float mean = 0.0f;
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+
+    static FrameStats From(const std::vector<float>& samples, std::size_t skip = 1);
+};
+
+// --benchmark 模式：固定的相機路徑與動畫時鐘，每次執行畫出來的東西都一樣，
+// 所以不同 commit 之間的數字可以直接比較
+namespace benchmark {
+    struct Report {
+        std::string renderer;
+        int frames = 0;
+        int quads = 0;
+        FrameStats frame;
+        FrameStats cpu;
+        FrameStats gpu;
+    };
+
+    // 依照時間（秒）把相機放到固定路徑上：左右來回掃過四邊形牆，途中有一部分會離開視錐
+    void FollowCameraPath(Camera& camera, float time);
+
+    void Print(const char* name, const FrameStats& stats);
+
+    bool WriteJson(const std::string& filename, const Report& report);
+
+    // 與之前的 JSON 報告比較 CPU 與 GPU 的 p95，慢了超過 threshold（比例）就算退步，回傳 false
+    bool CompareWithBaseline(const std::string& filename, const Report& report, float threshold);
+}
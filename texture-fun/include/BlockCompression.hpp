@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+struct ThreadPool;
+
+// BC1（DXT1）與 BC3（DXT5）的 block 編碼與解碼，每個 4x4 的 block 各自獨立處理。
+// 像素固定是 RGBA8、逐列緊密排列；寬高不是 4 的倍數時，邊緣的 block 重複最後一列（行）補滿。
+namespace bcn {
+    enum class Format {
+        Bc1,  // RGB，每個 block 8 bytes（4 bpp）
+        Bc3,  // RGBA，每個 block 16 bytes（8 bpp），alpha 另外以 8 階內插
+    };
+
+    std::size_t BlockBytes(Format format);
+    std::size_t CompressedSize(Format format, int width, int height);
+
+    // 端點取 block 的主軸（covariance 的 power iteration）再做一次最小平方修正。
+    // pool 不為 nullptr 時以 block row 為單位分給 worker，回傳前會等待全部完成
+    void Encode(Format format, const unsigned char* rgba, int width, int height, unsigned char* out, ThreadPool* pool = nullptr);
+
+    void Decode(Format format, const unsigned char* blocks, int width, int height, unsigned char* rgba);
+}
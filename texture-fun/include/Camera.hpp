@@ -4,6 +4,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 
+#include "Frustum.hpp"
+
 enum CameraMovement : unsigned int {
     LEFT = 0,
     RIGHT = 1,
@@ -35,6 +37,8 @@ struct Camera {
     } frustum;
     std::vector <glm::vec4> nearPlaneVertex;
     std::vector <glm::vec4> farPlaneVertex;
+    // 世界座標的視錐平面，每次 Update 後重新計算，給 culling 使用
+    Frustum ViewFrustum;
 
     float AspectRatio();
     glm::mat4 View();
@@ -46,11 +50,19 @@ struct Camera {
     void ProcessMouseMovement(bool constrain = true);
     void ProcessMouseScroll(float yoffset);
     void ToggleMouseControl();
+    // Step 以固定的 dt 推進模擬（速度、位置），Interpolate 再依照 alpha 在上一個與目前的 tick 之間決定畫面上的位置；
+    // Update 等於 Step 之後直接顯示最新的狀態
+    void Step(float dt);
+    void Interpolate(float alpha);
     void Update(float dt);
     void UpdateTargetPosition(glm::vec3 target);
+    void UpdateViewFrustum();
 
     float Pitch, Yaw, Roll;
     glm::vec3 Position;
+    // 上一個 tick 的 Position，以及 View() 實際使用、內插之後的位置
+    glm::vec3 PreviousPosition;
+    glm::vec3 RenderPosition;
     glm::vec3 Velocity;
     glm::vec3 Acceleration;
     glm::vec3 WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
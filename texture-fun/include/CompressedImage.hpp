@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 常用的 block 壓縮格式（GL 的 internal format 數值），這裡不引入 glad，讓 CPU 端的工具也能使用
+namespace compressed_format {
+    constexpr std::uint32_t Bc1 = 0x83F0;       // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    constexpr std::uint32_t Bc3 = 0x83F3;       // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+    constexpr std::uint32_t Bc7 = 0x8E8C;       // GL_COMPRESSED_RGBA_BPTC_UNORM
+    constexpr std::uint32_t Etc2Rgb = 0x9274;   // GL_COMPRESSED_RGB8_ETC2
+    constexpr std::uint32_t Etc2Rgba = 0x9278;  // GL_COMPRESSED_RGBA8_ETC2_EAC
+
+    // 每個 4x4 block 的大小，不認得的格式回傳 0
+    std::size_t BlockBytes(std::uint32_t internal_format);
+    std::size_t LevelSize(std::uint32_t internal_format, int width, int height);
+}
+
+// 已經壓縮好的貼圖（含 mip chain），以 KTX 1.1 檔案存放。資料跟 Image 一樣已經上下翻轉成 OpenGL 的列順序。
+// 讀檔時使用 mmap，每一層的 data 都指向映射的記憶體，不會另外複製。
+struct CompressedImage {
+    struct Level {
+        int width;
+        int height;
+        std::size_t size;  // 整層的大小，array 時包含所有 layer（依 layer 順序緊密排列）
+        std::shared_ptr<const unsigned char> data;
+    };
+
+    CompressedImage() = default;
+    explicit CompressedImage(const std::string& filename);
+
+    bool IsValid() const;
+    bool Save(const std::string& filename) const;
+
+    std::uint32_t internal_format = 0;
+    std::uint32_t base_format = 0;
+    int width = 0;
+    int height = 0;
+    int layers = 0;  // 0 表示一般的 2D 貼圖，大於 0 表示 2D array
+    std::vector<Level> levels;
+
+    // KTX 的 key/value 資料，例如 GIF 每個影格的延遲時間
+    std::map<std::string, std::string> metadata;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// 固定步長的模擬時鐘：把每個 frame 經過的時間累積起來，每滿一個 Step 就跑一次模擬，
+// 所以不論 30 FPS 還是 240 FPS，模擬的結果都一樣。剩下不足一個 Step 的部分以 Alpha 表示，
+// 畫面用 Alpha 在上一個與目前的模擬狀態之間內插，避免 frame rate 與 tick rate 不同步時的抖動。
+struct FixedTimestep {
+    explicit FixedTimestep(double tick_rate = 60.0, int max_steps = 8);
+
+    // 加上這個 frame 經過的時間（秒），回傳這個 frame 要跑幾個 tick。
+    // 最多 max_steps 個，太慢的機器會讓模擬變慢，而不是每個 frame 越追越多（spiral of death）
+    int Advance(double frame_time);
+
+    // 跑完一個 tick 之後呼叫
+    void Tick();
+
+    double Step() const;
+    double TickRate() const;
+
+    // 目前模擬到的時間（tick 數乘上 Step）
+    double Time() const;
+    std::uint64_t Ticks() const;
+
+    // 累積下來還沒模擬的時間佔一個 Step 的比例，介於 [0, 1)
+    float Alpha() const;
+
+    // 畫面應該呈現的時間。內插是在上一個與目前的 tick 之間，所以畫面固定落後模擬一個 Step：(Ticks() - 1 + Alpha) * Step
+    double RenderTime() const;
+
+private:
+    double m_step;
+    int m_max_steps;
+    double m_accumulator;
+    std::uint64_t m_ticks;
+};
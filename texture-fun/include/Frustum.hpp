@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// 世界座標中的六個視錐平面，每個平面為 (a, b, c, d)，法向量朝內並且已經正規化，
+// 點 p 在平面內側代表 a * p.x + b * p.y + c * p.z + d >= 0
+struct Frustum {
+    enum Side : int { Left = 0, Right = 1, Bottom = 2, Top = 3, Near = 4, Far = 5 };
+
+    glm::vec4 planes[6];
+
+    // 從 projection * view 取出平面（Gribb & Hartmann）
+    static Frustum FromMatrix(const glm::mat4& view_projection);
+
+    bool IntersectsSphere(const glm::vec3& center, float radius) const;
+    bool IntersectsAabb(const glm::vec3& center, const glm::vec3& extent) const;
+};
+
+// 以 SoA 儲存的包圍體批次測試，一次測 4 個（SSE），visible[i] 為 1 代表與視錐相交，回傳可見的數量
+namespace culling {
+    std::size_t CullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+        std::size_t count, std::uint8_t* visible);
+
+    // AABB 以中心點與半邊長表示
+    std::size_t CullAabbs(const Frustum& frustum, const float* x, const float* y, const float* z,
+        const float* extent_x, const float* extent_y, const float* extent_z, std::size_t count, std::uint8_t* visible);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "CompressedImage.hpp"
+
+// 執行期檢查 context 支援的功能（gladLoadGLLoader 之後才有意義）。
+// 用 #if 包起來是因為 glad 只會替產生時有選到的版本與擴充定義這些旗標。
+namespace gl_features {
+    inline bool BufferStorage() {
+#if defined(GL_VERSION_4_4)
+        if (GLAD_GL_VERSION_4_4) {
+            return true;
+        }
+#endif
+#if defined(GL_ARB_buffer_storage)
+        if (GLAD_GL_ARB_buffer_storage) {
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    inline bool ProgramBinary() {
+        bool supported = false;
+#if defined(GL_VERSION_4_1)
+        supported = supported || GLAD_GL_VERSION_4_1;
+#endif
+#if defined(GL_ARB_get_program_binary)
+        supported = supported || GLAD_GL_ARB_get_program_binary;
+#endif
+        if (!supported) {
+            return false;
+        }
+        // 支援這個擴充但沒有任何 binary format 的 driver 也不能用
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+
+    // glTexStorage*：一次配置好大小與 mip 層數固定的 immutable storage
+    inline bool TextureStorage() {
+#if defined(GL_VERSION_4_2)
+        if (GLAD_GL_VERSION_4_2) {
+            return true;
+        }
+#endif
+#if defined(GL_ARB_texture_storage)
+        if (GLAD_GL_ARB_texture_storage) {
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    inline bool TextureFilterAnisotropic() {
+#if defined(GL_VERSION_4_6)
+        if (GLAD_GL_VERSION_4_6) {
+            return true;
+        }
+#endif
+#if defined(GL_ARB_texture_filter_anisotropic)
+        if (GLAD_GL_ARB_texture_filter_anisotropic) {
+            return true;
+        }
+#endif
+#if defined(GL_EXT_texture_filter_anisotropic)
+        if (GLAD_GL_EXT_texture_filter_anisotropic) {
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    // 能否把這個 block 壓縮格式直接交給 glCompressedTexImage*
+    inline bool CompressedFormat(std::uint32_t internal_format) {
+        bool supported = false;
+        switch (internal_format) {
+            case compressed_format::Bc1:
+            case compressed_format::Bc3:
+#if defined(GL_EXT_texture_compression_s3tc)
+                supported = supported || GLAD_GL_EXT_texture_compression_s3tc;
+#endif
+                return supported;
+            case compressed_format::Bc7:
+#if defined(GL_VERSION_4_2)
+                supported = supported || GLAD_GL_VERSION_4_2;
+#endif
+#if defined(GL_ARB_texture_compression_bptc)
+                supported = supported || GLAD_GL_ARB_texture_compression_bptc;
+#endif
+                return supported;
+            case compressed_format::Etc2Rgb:
+            case compressed_format::Etc2Rgba:
+                // 桌面版的 ETC2 多半是 driver 在上傳時解壓縮，仍然可以用，只是省不到 VRAM
+#if defined(GL_VERSION_4_3)
+                supported = supported || GLAD_GL_VERSION_4_3;
+#endif
+#if defined(GL_ARB_ES3_compatibility)
+                supported = supported || GLAD_GL_ARB_ES3_compatibility;
+#endif
+                return supported;
+            default:
+                return false;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <vector>
+
+// 以 GL_TIME_ELAPSED query 量每個 frame 的 GPU 時間（GL 3.3 core 就有）。
+// 結果要等 GPU 執行完才拿得到，所以用一個 ring 輪流使用 Latency 個 query，
+// 只有在 GPU 落後超過 Latency 個 frame 時 Begin 才會等待；同一時間只能有一個 GL_TIME_ELAPSED query 在量測中。
+struct GpuTimer {
+    static constexpr std::size_t Latency = 4;
+
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void Begin();
+    void End();
+
+    // 取回所有還沒讀的結果（會等 GPU 做完），結束量測時呼叫
+    void Finish();
+
+    // 依 frame 順序排列的 GPU 時間（毫秒）
+    const std::vector<float>& Samples() const;
+
+private:
+    GLuint m_queries[Latency];
+    bool m_pending[Latency];
+    std::size_t m_next;
+    std::vector<float> m_samples;
+
+    void Collect(std::size_t slot);
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// 64-bit FNV-1a，可以在編譯期計算，也用來產生快取檔案的 key
+namespace hash {
+    constexpr std::uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+    constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+
+    constexpr std::uint64_t Fnv1a(std::string_view text, std::uint64_t seed = kFnvOffsetBasis) {
+        std::uint64_t value = seed;
+        for (char c : text) {
+            value ^= static_cast<unsigned char>(c);
+            value *= kFnvPrime;
+        }
+        return value;
+    }
+
+    inline std::uint64_t Fnv1a(const void* data, std::size_t size, std::uint64_t seed = kFnvOffsetBasis) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        std::uint64_t value = seed;
+        for (std::size_t i = 0; i < size; ++i) {
+            value ^= bytes[i];
+            value *= kFnvPrime;
+        }
+        return value;
+    }
+}
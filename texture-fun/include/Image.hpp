@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// CPU 端已解碼的圖片，與 OpenGL 無關，所以可以在任意執行緒上建立。
+struct Image {
+    struct MipLevel {
+        int width;
+        int height;
+        std::shared_ptr<const unsigned char> pixels;
+    };
+
+    Image() = default;
+    explicit Image(const std::string& filename);
+    Image(const unsigned char* buffer, std::size_t length);
+
+    bool IsValid() const;
+    std::size_t Size() const;
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::shared_ptr<const unsigned char> pixels;
+
+    // level 1 以後的 mip chain，只有在 CPU 產生 mipmap 時才會有資料
+    std::vector<MipLevel> mipmaps;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Image.hpp"
+#include "Mipmap.hpp"
+
+#include <cstdint>
+#include <string>
+
+// 把解碼（並已上下翻轉）後的像素存成二進位快取檔，下次啟動時直接 mmap，不必再經過 PNG 的 inflate。
+// 快取以來源檔案路徑（與 mipmap filter）命名，檔頭記錄來源的大小、修改時間與內容雜湊，來源改變時會自動重建。
+// 使用 CPU mipmap 時整條 mip chain 也會一起存進快取。
+struct ImageCache {
+    static constexpr std::uint32_t kVersion = 2;
+
+    // directory 為空字串時不使用磁碟快取，每次都重新解碼（例如只量測解碼本身的速度）
+    explicit ImageCache(const std::string& directory = ".cache/textures");
+
+    static ImageCache& Default();
+
+    Image Load(const std::string& filename, MipmapFilter filter = MipmapFilter::Driver);
+
+private:
+    std::string m_directory;
+
+    std::string CachePath(const std::string& filename, MipmapFilter filter) const;
+    void Store(const std::string& cache_path, const Image& image, MipmapFilter filter, std::uint64_t source_size,
+        std::int64_t source_mtime, std::uint64_t source_hash) const;
+};
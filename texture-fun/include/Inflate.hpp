@@ -0,0 +1,10 @@
+#pragma once
+
+// 取代 stb_image 內建 zlib 的 inflate 實作：
+//   - 64-bit bit buffer，每次 refill 一次讀入 8 bytes
+//   - 11-bit 的 literal/length 查表，兩個短的 literal 會被合併在同一個 entry 中一次解出（multi-symbol）
+//   - 長度 >= 8 的 match 以 8 bytes 為單位複製
+// 介面與 stbi_zlib_decode_malloc_guesssize_headerflag() 相同，回傳的記憶體以 free() 釋放。
+namespace fast_inflate {
+    char* DecodeZlibMalloc(const char* buffer, int len, int initial_size, int* outlen, int parse_header);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+// Camera、SceneGraph（每個 frame 重算 local / world matrix）與 MatrixStack（排列靜態場景）用到的 4x4 矩陣運算。
+// 有 SSE 時以一個 __m128 裝一個 column 計算，否則退回 glm 的純量版本，結果與 glm 在浮點誤差內一致。
+namespace matrix {
+    // out = a * b，out 可以與 a 或 b 是同一個矩陣
+    void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out);
+    glm::mat4 Multiply(const glm::mat4& a, const glm::mat4& b);
+
+    // out[i] = parent * locals[i]，一次處理一整批矩陣（parent 只需載入一次）
+    void MultiplyBatch(const glm::mat4& parent, const glm::mat4* locals, glm::mat4* out, std::size_t count);
+
+    glm::vec4 Transform(const glm::mat4& m, const glm::vec4& v);
+
+    // 僅適用於最後一列為 (0, 0, 0, 1) 的仿射矩陣（旋轉、縮放、平移），比一般的 glm::inverse 便宜很多
+    glm::mat4 AffineInverse(const glm::mat4& m);
+
+    // 以下三個等價於 glm::translate / glm::rotate / glm::scale，但直接修改 m
+    void Translate(glm::mat4& m, const glm::vec3& offset);
+    void Rotate(glm::mat4& m, float radians, const glm::vec3& axis);
+    void Scale(glm::mat4& m, const glm::vec3& factor);
+
+    // 繞任意軸旋轉的矩陣（axis 不需要先正規化）
+    glm::mat4 Rotation(float radians, const glm::vec3& axis);
+
+    // 等價於 glm::lookAt
+    glm::mat4 LookAt(const glm::vec3& eye, const glm::vec3& center, const glm::vec3& up);
+}
@@ -1,17 +1,31 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include <stack>
 
+#include <array>
+#include <cstddef>
+
+// 固定容量、連續記憶體的矩陣堆疊：建構後不再配置記憶體，
+// Translate / Rotate / Scale 直接乘在 Top 上，不必先複製出來再 Save 回去。
+// 最底層固定是一個單位矩陣，永遠不會被 Pop；超過 Capacity 的 Push 與只剩 root 時的 Pop 都會直接結束程式。
 struct MatrixStack {
+    static constexpr std::size_t Capacity = 32;
+
     MatrixStack();
 
     void Push();
     void Pop();
     void Save(const glm::mat4& matrix);
     bool IsEmpty() const;
-    glm::mat4 Top() const;
+    std::size_t Size() const;
+    const glm::mat4& Top() const;
+
+    void Translate(const glm::vec3& offset);
+    void Rotate(float radians, const glm::vec3& axis);
+    void Scale(const glm::vec3& factor);
+    void Multiply(const glm::mat4& matrix);
 
 private:
-    std::stack<glm::mat4> stack;
+    alignas(16) std::array<glm::mat4, Capacity> m_stack;
+    std::size_t m_size;
 };
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Image.hpp"
+
+enum class MipmapFilter : int {
+    Driver = 0,   // 交給 glGenerateMipmap
+    Box = 1,      // CPU 上的 2x2 box filter，直接平均編碼後的數值
+    SrgbBox = 2,  // CPU 上的 2x2 box filter，先轉到線性空間再平均（alpha 維持線性）
+};
+
+namespace mipmap {
+    int LevelCount(int width, int height);
+
+    // 將 src 縮小一半到 dst，dst 的大小為 max(1, width / 2) x max(1, height / 2)
+    void Downsample(const unsigned char* src, int width, int height, int channels, unsigned char* dst, MipmapFilter filter);
+
+    // 替 image 產生完整的 mip chain（存放在 image.mipmaps，直到 1x1 為止）
+    void Generate(Image& image, MipmapFilter filter);
+}
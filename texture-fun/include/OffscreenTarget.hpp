@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+// headless 模式的 render target：隱藏視窗的 default framebuffer 內容是未定義的，所以改畫在自己的 FBO 上，
+// 需要的話再用 WritePpm 讀回來存檔。沒有 GPU 的 Linux 可以搭配 llvmpipe 與 SDL_VIDEODRIVER=offscreen 或 Xvfb 執行。
+struct OffscreenTarget {
+    OffscreenTarget(int width, int height);
+    ~OffscreenTarget();
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    void Bind() const;
+
+    int width;
+    int height;
+
+private:
+    GLuint m_framebuffer;
+    GLuint m_color;
+    GLuint m_depth;
+};
+
+namespace offscreen {
+    // 讀取目前綁定的 framebuffer 存成 binary PPM（P6）
+    bool WritePpm(const std::string& filename, int width, int height);
+
+    // 存成 directory/frame_NNNNN.ppm，directory 不存在時會自動建立
+    void DumpFrame(const std::string& directory, int frame, int width, int height);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <deque>
+
+// 透過 pixel buffer object 的 ring buffer 上傳貼圖，避免 glTexImage2D 從 client memory 同步複製時卡住 render thread。
+//   - GL 4.4 / ARB_buffer_storage：整個 ring 以 persistent + coherent 的方式 map 一次，
+//     每次上傳後放一個 fence，要重複使用那段空間前才等待 GPU 讀完。
+//   - GL 3.3：每次寫入時以 MAP_UNSYNCHRONIZED map 一段空間，ring 繞回開頭時 orphan 整個 buffer。
+// 只能在擁有 GL context 的執行緒上使用。
+struct PixelUploader {
+    // readable 時 persistent mapping 額外加上 GL_MAP_READ_BIT，寫進 staging 的資料可以再讀回來（例如從 level 0 產生 mipmap）；
+    // orphaning 的 mapping 一律只能寫
+    explicit PixelUploader(std::size_t capacity = 32 * 1024 * 1024, bool readable = false);
+    ~PixelUploader();
+
+    PixelUploader(const PixelUploader&) = delete;
+    PixelUploader& operator=(const PixelUploader&) = delete;
+
+    // Default() 是 function-local static，解構時 GL context 早就不在了；必須在刪除 context 之前呼叫 Shutdown()。
+    // 之後再次上傳時會重新建立 ring
+    static PixelUploader& Default();
+    void Shutdown();
+
+    // 設為 false 時一律直接從 client memory 上傳（用來比較 frame time）
+    bool enabled = true;
+
+    struct Staging {
+        unsigned char* data = nullptr;
+        std::size_t offset = 0;
+        std::size_t size = 0;
+    };
+
+    // 建立 ring；第一次 Allocate 時會自動呼叫，需要事先知道 IsPersistent() 時才需要自己呼叫
+    void Initialize();
+
+    // 直接寫入 mapped memory 的 staging API：Allocate -> 寫入 data -> TexSubImage2D（可以多次，例如整條 mip chain）-> Submit。
+    //   - 超過 ring 大小或停用時 data 為 nullptr，呼叫者要自己退回 client memory。
+    //   - orphaning 時 data 只在下一次 TexSubImage2D 之前有效，而且 Submit 之前不能再次 Allocate。
+    //   - persistent 時 data 一直有效，可以交給其他執行緒寫入，Submit 之前也可以再 Allocate 其他空間；
+    //     寫好之後才在擁有 GL context 的執行緒上呼叫 TexSubImage2D。沒有 Submit 的空間不受 fence 保護，
+    //     ring 繞一圈之後就會再被分配出去，所以同時保留的空間總和必須小於 capacity。
+    Staging Allocate(std::size_t size);
+    // 從 staging 中 offset 開始的資料更新 target 的一個 level
+    void TexSubImage2D(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type, const Staging& staging,
+        std::size_t offset = 0);
+    // 同上，更新 2D array 的一個 layer
+    void TexSubImage3D(GLenum target, GLint level, GLint layer, GLsizei width, GLsizei height, GLenum format, GLenum type,
+        const Staging& staging, std::size_t offset = 0);
+    // 這段 staging 的上傳都送出之後呼叫一次：persistent ring 放一個 fence，要重複使用這段空間前才等待 GPU 讀完
+    void Submit(const Staging& staging);
+
+    // 複製到 ring 之後再上傳；無法使用 ring 時退回 client memory
+    void Upload2D(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels, std::size_t size);
+    void Upload3D(GLenum target, GLint level, GLint layer, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels,
+        std::size_t size);
+
+    bool IsPersistent() const;
+    // Allocate 取得的 data 是否可以讀回
+    bool CanRead() const;
+
+private:
+    struct Fence {
+        std::size_t begin;
+        std::size_t end;
+        GLsync sync;
+    };
+
+    void WaitForRange(std::size_t begin, std::size_t end);
+
+    std::size_t m_capacity;
+    std::size_t m_head;
+    GLuint m_buffer;
+    unsigned char* m_mapped;
+    bool m_initialized;
+    bool m_persistent;
+    bool m_readable;
+    // orphaning 時 Allocate 之後、TexSubImage2D 之前，buffer 處於 map 的狀態
+    bool m_range_mapped;
+    std::deque<Fence> m_in_flight;
+};
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 輕量的 profiler：
+//   - CPU：PROFILE_ZONE("name") 以 RAII 記錄一段程式的開始與結束時間，每個執行緒寫進自己的 ring buffer，不需要 lock。
+//   - GPU：GpuProfiler 以 GL_TIME_ELAPSED query 量測每個 zone，兩組 query pool 輪流使用，
+//     讀回的是前一輪的結果（通常早已完成），所以 CPU 不會停下來等 GPU。
+// 結果可以輸出成 Chrome trace（chrome://tracing 或 ui.perfetto.dev 開啟），或用 Summarize 取得各 zone 的合計時間。
+// zone 的名稱只存指標，必須是字串常數。沒有 SetEnabled(true) 時每個 zone 只多一次 atomic 讀取。
+namespace profiler {
+    using Clock = std::chrono::steady_clock;
+
+    // 每個執行緒最多保留的事件數，滿了之後覆蓋最舊的
+    constexpr std::size_t kEventsPerThread = 1 << 16;
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled();
+
+    // Chrome trace 上顯示的執行緒名稱，預設為 "Thread N"
+    void SetThreadName(const std::string& name);
+
+    struct ScopedZone {
+        explicit ScopedZone(const char* name);
+        ~ScopedZone();
+
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+    private:
+        const char* m_name;
+        Clock::time_point m_start;
+    };
+
+    // 只能在擁有 GL context 的執行緒上使用。GL_TIME_ELAPSED 不能巢狀，所以 GPU zone 之間不能重疊，
+    // 也不能跟其他 GL_TIME_ELAPSED query（例如 GpuTimer）同時使用。
+    struct GpuProfiler {
+        static constexpr std::size_t MaxZonesPerFrame = 32;
+
+        GpuProfiler();
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        // 每個 frame 開頭呼叫：換到另一組 pool，並讀回它上一次（兩個 frame 前）的結果
+        void BeginFrame();
+        void Begin(const char* name);
+        void End();
+
+        // 讀回所有還沒讀的結果（會等 GPU 做完），輸出 trace 之前呼叫
+        void Finish();
+
+        // 讀回結果時 GPU 還沒做完、只好等待的次數
+        std::size_t Stalls() const;
+
+    private:
+        struct Pool {
+            GLuint queries[MaxZonesPerFrame];
+            const char* names[MaxZonesPerFrame];
+            Clock::time_point issued[MaxZonesPerFrame];
+            std::size_t count;
+        };
+
+        Pool m_pools[2];
+        std::size_t m_current;
+        bool m_open;
+        std::size_t m_stalls;
+
+        void Resolve(Pool& pool);
+    };
+
+    // profiler 為 nullptr 時什麼都不做
+    struct ScopedGpuZone {
+        ScopedGpuZone(GpuProfiler* profiler, const char* name);
+        ~ScopedGpuZone();
+
+        ScopedGpuZone(const ScopedGpuZone&) = delete;
+        ScopedGpuZone& operator=(const ScopedGpuZone&) = delete;
+
+    private:
+        GpuProfiler* m_profiler;
+    };
+
+    struct ZoneTotal {
+        std::string name;
+        bool gpu = false;
+        std::size_t calls = 0;
+        double milliseconds = 0.0;
+    };
+
+    // 結束時間落在 [from, to) 之間的 zone，依名稱合計，GPU 的排在 CPU 之後，各自依時間由多到少排列。
+    // 巢狀的 zone 各自計算，所以合計會重複計入。
+    std::vector<ZoneTotal> Summarize(Clock::time_point from, Clock::time_point to);
+
+    // 以每個 frame 的平均時間印出 Summarize 的結果
+    void PrintSummary(Clock::time_point from, Clock::time_point to, int frames);
+
+    // 所有執行緒與 GPU 保留下來的事件，應該在沒有其他執行緒正在記錄時呼叫
+    bool WriteChromeTrace(const std::string& filename);
+
+#ifdef TEXTURE_FUN_PROFILER_OVERLAY
+    // 在目前的 ImGui frame 中畫出各 zone 每個 frame 的平均時間（ImGui::NewFrame 與 ImGui::Render 之間呼叫）
+    void DrawOverlay();
+#endif
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) profiler::ScopedZone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 把 link 好的 shader program 以 glGetProgramBinary 存到磁碟，下次啟動時以 glProgramBinary 直接載入，省下編譯與 link 的時間。
+// key 包含所有 shader 原始碼以及 driver 的 vendor / renderer / version 字串，任何一個改變都會重新編譯；
+// driver 拒絕 binary 時（例如更新了 driver）會安靜地退回一般的編譯流程。
+struct ProgramCache {
+    static constexpr std::uint32_t kVersion = 1;
+
+    explicit ProgramCache(const std::string& directory = ".cache/shaders");
+
+    static ProgramCache& Default();
+
+    std::uint64_t Key(const std::vector<std::string>& sources) const;
+
+    // 成功時 program 已經是 link 好的狀態
+    bool Load(std::uint64_t key, GLuint program);
+    void Store(std::uint64_t key, GLuint program);
+
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+
+private:
+    std::string m_directory;
+
+    std::string CachePath(std::uint64_t key) const;
+};
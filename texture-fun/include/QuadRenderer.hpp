@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Shader.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// 以 instancing 一次畫出大量貼圖四邊形：每個 instance 的 model matrix 與 texture layer 收集在 CPU 端，
+// Flush 時一次寫進 instance VBO，每種 material（shader + 貼圖）只需要一個 glDrawElementsInstanced。
+// 頂點著色器需要使用 instanced.vert 的 attribute 配置（location 2~5 為 model matrix，6 為 layer）。
+struct QuadRenderer {
+    struct Instance {
+        glm::mat4 model;
+        float layer;
+    };
+
+    explicit QuadRenderer(std::size_t max_instances = 65536);
+    ~QuadRenderer();
+
+    QuadRenderer(const QuadRenderer&) = delete;
+    QuadRenderer& operator=(const QuadRenderer&) = delete;
+
+    // 回傳 material 的編號，texture_target 為 GL_TEXTURE_2D 或 GL_TEXTURE_2D_ARRAY。
+    // sampler 為 SamplerCache 取得的 sampler object，0 表示使用貼圖本身的取樣參數
+    std::size_t AddMaterial(Shader& shader, GLenum texture_target, GLuint texture, GLuint sampler = 0);
+    // 換掉 material 使用的貼圖（例如 TextureResidency 從 placeholder 換成載入完成的貼圖）
+    void SetTexture(std::size_t material, GLuint texture);
+
+    void Submit(std::size_t material, const glm::mat4& model, float layer = 0.0f);
+    void Flush();
+
+    std::size_t DrawCalls() const;
+
+private:
+    struct Material {
+        Shader* shader;
+        GLenum texture_target;
+        GLuint texture;
+        GLuint sampler;
+        std::vector<Instance> instances;
+    };
+
+    GLuint m_vao;
+    GLuint m_vertex_buffer;
+    GLuint m_index_buffer;
+    GLuint m_instance_buffer;
+    std::size_t m_max_instances;
+    std::size_t m_draw_calls;
+    std::vector<Material> m_materials;
+
+    void SetInstanceOffset(std::size_t first_instance);
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <vector>
+
+// 取樣方式（wrap、filter、anisotropy）。跟貼圖分開，同一張貼圖可以搭配不同的 sampler 畫出來
+struct SamplerState {
+    GLenum wrap_s = GL_MIRRORED_REPEAT;
+    GLenum wrap_t = GL_MIRRORED_REPEAT;
+    GLenum min_filter = GL_LINEAR_MIPMAP_LINEAR;
+    GLenum mag_filter = GL_LINEAR;
+    // 1 表示關閉；大於 context 支援的最大值時會被夾住，不支援 anisotropic filtering 時忽略
+    float anisotropy = 1.0f;
+
+    bool operator==(const SamplerState& other) const;
+};
+
+// 以 SamplerState 去除重複的 sampler object（glGenSamplers），相同的狀態只會建立一個。
+// 繪製時以 glBindSampler 綁到 texture unit 上，會覆蓋貼圖本身的取樣參數，切換 filter 不必改動任何貼圖。
+// 只能在擁有 GL context 的執行緒上使用。
+struct SamplerCache {
+    SamplerCache();
+    ~SamplerCache();
+
+    SamplerCache(const SamplerCache&) = delete;
+    SamplerCache& operator=(const SamplerCache&) = delete;
+
+    GLuint Get(const SamplerState& state);
+
+    // context 支援的最大 anisotropy，不支援時為 1
+    float MaxAnisotropy() const;
+    std::size_t Size() const;
+
+private:
+    struct Entry {
+        SamplerState state;
+        GLuint sampler;
+    };
+
+    std::vector<Entry> m_samplers;
+    float m_max_anisotropy;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+#include "QuadRenderer.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 扁平、以陣列儲存（SoA）的場景樹：local / world matrix、parent、dirty flag 各自是一個連續陣列。
+// 節點只能掛在已經存在的節點底下，所以 parent 的編號一定比 child 小，依編號順序走一遍就能把 dirty 往下傳。
+// Update 依深度一層一層計算 world matrix，同一層的節點互不相依，可以切塊丟給 ThreadPool 平行處理。
+struct SceneGraph {
+    static constexpr std::uint32_t NoParent = 0xFFFFFFFFu;
+    static constexpr std::size_t NoMaterial = static_cast<std::size_t>(-1);
+
+    explicit SceneGraph(ThreadPool* pool = nullptr);
+
+    std::uint32_t AddNode(std::uint32_t parent = NoParent, const glm::mat4& local = glm::mat4(1.0f));
+
+    void SetLocal(std::uint32_t node, const glm::mat4& local);
+    // local = translate(translation) * rotate(radians, axis) * scale(factor)
+    void SetTransform(std::uint32_t node, const glm::vec3& translation, float radians, const glm::vec3& axis,
+        const glm::vec3& factor);
+    // 有 material 的節點會在 Submit 時交給 QuadRenderer 畫出來
+    void SetMaterial(std::uint32_t node, std::size_t material, float layer = 0.0f);
+
+    const glm::mat4& Local(std::uint32_t node) const;
+    const glm::mat4& World(std::uint32_t node) const;
+    std::size_t Size() const;
+
+    // 只重新計算自己或祖先被修改過的節點，回傳這次更新的節點數
+    std::size_t Update();
+    // 有 frustum 時會先以每個節點的 AABB 做 culling，只送出看得到的節點，回傳送出的數量
+    std::size_t Submit(QuadRenderer& renderer, const Frustum* frustum = nullptr);
+
+private:
+    std::vector<glm::mat4> m_local;
+    std::vector<glm::mat4> m_world;
+    std::vector<std::uint32_t> m_parent;
+    std::vector<std::uint8_t> m_dirty;
+    std::vector<std::size_t> m_material;
+    std::vector<float> m_layer;
+    // 世界座標的 AABB（中心與半邊長），每個節點都當作 QuadRenderer 的單位四邊形，隨 world matrix 一起更新
+    std::vector<float> m_center_x, m_center_y, m_center_z;
+    std::vector<float> m_extent_x, m_extent_y, m_extent_z;
+    std::vector<std::uint8_t> m_visible;
+    // 每一層深度的節點編號，同一層之內依編號排序
+    std::vector<std::vector<std::uint32_t>> m_levels;
+    std::vector<std::uint32_t> m_depth;
+    ThreadPool* m_pool;
+    // 編號比這個小的節點都不是 dirty（child 的編號一定比 parent 大），Update 從這裡開始即可
+    std::size_t m_first_dirty;
+
+    void MarkDirty(std::uint32_t node);
+    void UpdateRange(const std::uint32_t* nodes, std::size_t count);
+};
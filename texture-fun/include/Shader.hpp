@@ -4,8 +4,15 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "Hash.hpp"
+#include "UniformBuffer.hpp"
+
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 enum ShaderType : GLenum {
     Vert = GL_VERTEX_SHADER,
@@ -16,6 +23,18 @@ enum ShaderType : GLenum {
     Comp = GL_COMPUTE_SHADER,
 };
 
+// 在編譯期就算好名稱雜湊值的 uniform 代號，Set* 時只需要在 link 後建立的表中查找整數。
+// 用法：static constexpr UniformHandle kModel("model"); 或 "model"_uniform
+struct UniformHandle {
+    std::uint64_t hash;
+
+    constexpr explicit UniformHandle(std::string_view name) : hash(hash::Fnv1a(name)) {}
+};
+
+constexpr UniformHandle operator""_uniform(const char* name, std::size_t length) {
+    return UniformHandle(std::string_view(name, length));
+}
+
 struct Shader {
     Shader(const std::string& vertex_path, const std::string& fragment_path);
     ~Shader();
@@ -30,12 +49,31 @@ struct Shader {
     void SetVec4(const std::string& uniform_name, const glm::vec4& vector);
     void SetMat4(const std::string& uniform_name, const glm::mat4& matrix);
 
+    void SetInt(UniformHandle uniform, int value);
+    void SetBool(UniformHandle uniform, bool value);
+    void SetFloat(UniformHandle uniform, float value);
+    void SetVec2(UniformHandle uniform, const glm::vec2& vector);
+    void SetVec3(UniformHandle uniform, const glm::vec3& vector);
+    void SetVec4(UniformHandle uniform, const glm::vec4& vector);
+    void SetMat4(UniformHandle uniform, const glm::mat4& matrix);
+
+    // 將 uniform block 接到指定的 binding point（找不到這個 block 時回傳 false）
+    bool BindUniformBlock(const std::string& block_name, GLuint binding);
+    const UniformBlockLayout* GetUniformBlock(const std::string& block_name) const;
+
 private:
     GLuint m_id;
-    std::unordered_map<std::string, GLuint> m_uniform_location_cache;
+    // link 之後反射出來的 (名稱雜湊, location)，依雜湊排序
+    std::vector<std::pair<std::uint64_t, GLint>> m_uniform_locations;
+    std::unordered_map<std::string, UniformBlockLayout> m_uniform_blocks;
 
-    GLuint CreateShader(const std::string& shader_filepath, ShaderType shader_type);
+    static std::string ReadSource(const std::string& shader_filepath);
+    void LinkFromSource(const std::string& vertex_source, const std::string& fragment_source);
+    GLuint CreateShader(const std::string& source, ShaderType shader_type);
     GLboolean CompileShader(const GLuint& shader_id);
     GLboolean LinkShaderProgram(const GLuint& program_id);
-    GLuint GetUniformLocation(const std::string& uniform_name);
+    GLint GetUniformLocation(const std::string& uniform_name);
+    GLint GetUniformLocation(UniformHandle uniform, const char* uniform_name = nullptr);
+    void ReflectUniforms();
+    void ReflectUniformBlocks();
 };
\ No newline at end of file
@@ -1,13 +1,44 @@
 #pragma once
 
 #include <glad/glad.h>
-#include "stb_image.h"
+#include "CompressedImage.hpp"
+#include "Image.hpp"
+#include "Mipmap.hpp"
 #include <iostream>
 #include <string>
+#include <vector>
+
+struct TextureOptions {
+    // Driver 代表使用 glGenerateMipmap，其餘選項會在 CPU 上產生 mip chain（並且可以一起存進 ImageCache）
+    MipmapFilter mipmap_filter = MipmapFilter::Driver;
+    // 以 glTexStorage* 配置大小與層數固定的空間，再用 glTexSubImage* 上傳；false 或 context 不支援時逐層呼叫 glTexImage*
+    bool immutable_storage = true;
+};
+
+// 上傳每列之間沒有 padding 的像素之前呼叫：每列的 byte 數能被幾整除，GL_UNPACK_ALIGNMENT 就設成幾（最多 8）。
+// 呼叫者上傳完之後要自己設回預設的 4
+void SetUnpackAlignment(GLsizei width, int channels);
 
 struct Texture {
     unsigned int id;
-    Texture(const std::string& filename);
+    // 在 GPU 上大約佔用的大小（含 mip chain；交給 glGenerateMipmap 時以 4/3 估算）
+    std::size_t bytes;
+    Texture(const std::string& filename, const TextureOptions& options = TextureOptions());
+    Texture(const Image& image, const TextureOptions& options = TextureOptions());
+    // 直接上傳壓縮好的 mip chain；context 不支援 BC1 / BC3 時先在 CPU 上解壓縮成 RGBA8（options 只看 immutable_storage）
+    explicit Texture(const CompressedImage& image, const TextureOptions& options = TextureOptions());
     ~Texture();
     void Bind();
+};
+
+// 將一段動畫的所有影格打包成一個 GL_TEXTURE_2D_ARRAY，切換影格時只要改變 layer uniform 即可，不必重新 Bind。
+// 影格可以是已經解碼好的圖片（例如 LoadGifFrames 的結果），或是 texture-compress 產生的 KTX（每個 layer 一個影格）
+struct TextureArray {
+    unsigned int id;
+    int layers;
+    // 所有影格必須有相同的大小與通道數
+    explicit TextureArray(const std::vector<Image>& images, const TextureOptions& options = TextureOptions());
+    explicit TextureArray(const CompressedImage& image, const TextureOptions& options = TextureOptions());
+    ~TextureArray();
+    void Bind();
 };
\ No newline at end of file
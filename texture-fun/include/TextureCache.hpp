@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Image.hpp"
+#include "Texture.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// 同一張圖片（正規化後的路徑 + 載入選項）只建立一個 GL texture，呼叫者拿到的是共用的 shared_ptr。
+// 快取本身只保留 weak_ptr，最後一個 handle 釋放時貼圖就會刪掉；再次載入同一個 key 時，
+// 只要還有人持有，就不會讀檔也不會上傳。只能在擁有 GL context 的執行緒上使用。
+struct TextureCache {
+    static TextureCache& Default();
+
+    // 沒有命中時同步讀檔（經過 ImageCache）並上傳
+    std::shared_ptr<Texture> Load(const std::string& filename, const TextureOptions& options = TextureOptions());
+    // 只查詢，不讀檔；沒有時回傳 nullptr（不計入 hits / misses）
+    std::shared_ptr<Texture> Find(const std::string& filename, const TextureOptions& options = TextureOptions());
+    // 以已經解碼好的圖片建立（例如背景執行緒載入完成的結果），同一個 key 已經存在時直接回傳既有的貼圖
+    std::shared_ptr<Texture> Insert(const std::string& filename, const TextureOptions& options, const Image& image);
+
+    // 目前還有人持有的貼圖數量與大小總和；Size 會順便清掉已經釋放的項目
+    std::size_t Size();
+    std::size_t ResidentBytes() const;
+
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+
+private:
+    std::unordered_map<std::string, std::weak_ptr<Texture>> m_textures;
+    // 呼叫者傳進來的字串 -> 正規化後的路徑，同一個字串只問一次檔案系統
+    std::unordered_map<std::string, std::string> m_canonical;
+
+    const std::string& CanonicalPath(const std::string& filename);
+    std::string Key(const std::string& filename, const TextureOptions& options);
+    void EraseExpired();
+};
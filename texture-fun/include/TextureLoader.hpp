@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Image.hpp"
+#include "ImageCache.hpp"
+#include "MPSCQueue.hpp"
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+// 在 ThreadPool 上解碼圖片，解碼完成的結果透過 lock-free 佇列交回主執行緒，
+// 主執行緒只需要負責把像素上傳到 GPU（建立 Texture）。
+struct TextureLoader {
+    struct Result {
+        std::size_t ticket = 0;
+        std::string filename;
+        Image image;
+    };
+
+    explicit TextureLoader(ThreadPool& pool, ImageCache& cache = ImageCache::Default());
+    ~TextureLoader();
+
+    std::size_t Enqueue(const std::string& filename, MipmapFilter filter = MipmapFilter::Driver);
+    bool Poll(Result& result);
+    std::size_t Pending() const;
+
+private:
+    ThreadPool& m_pool;
+    ImageCache& m_cache;
+    MPSCQueue<Result> m_completed;
+    std::size_t m_next_ticket;
+    std::atomic<std::size_t> m_pending;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "Texture.hpp"
+#include "TextureLoader.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 控制貼圖佔用的 VRAM：每張貼圖記錄自己的大小（含 mip chain），總和超過預算時，
+// 把最久沒有被 Acquire 的貼圖刪掉。像素仍然留在 ImageCache 的磁碟快取中，
+// 之後再被用到時由 TextureLoader 在背景重新載入，載入完成之前先回傳一張灰色的 placeholder。
+// 貼圖經由 TextureCache 建立，別處已經載入同一張圖片時直接共用；這時刪掉只是放開自己的 handle。
+// 只能在擁有 GL context 的執行緒上使用。
+struct TextureResidency {
+    using Handle = std::size_t;
+
+    struct Stats {
+        std::size_t loads = 0;      // 背景載入完成的次數（包含第一次）
+        std::size_t evictions = 0;  // 因為超過預算而刪掉的次數
+        std::size_t misses = 0;     // Acquire 時不在 VRAM 中、只能先用 placeholder 的次數
+    };
+
+    // budget_bytes 為 0 表示不限制
+    TextureResidency(ThreadPool& pool, std::size_t budget_bytes, const TextureOptions& options = TextureOptions());
+    ~TextureResidency();
+
+    TextureResidency(const TextureResidency&) = delete;
+    TextureResidency& operator=(const TextureResidency&) = delete;
+
+    // 只登記檔名，不會載入
+    Handle Add(const std::string& filename);
+
+    // 回傳這個 frame 可以綁定的貼圖並標記為最近用過；不在 VRAM 中時開始背景載入，先回傳 placeholder
+    GLuint Acquire(Handle handle);
+    // 提前開始背景載入，不標記為用過
+    void Prefetch(Handle handle);
+    bool IsResident(Handle handle) const;
+
+    // 每個 frame 呼叫一次：上傳背景載入完成的圖片，再依 LRU 刪掉超出預算的貼圖。
+    // 這個 frame 已經 Acquire 過的貼圖不會被刪，所以同時用到的貼圖太多時會暫時超出預算
+    void Update();
+    // 等待所有背景載入完成並上傳（例如第一個 frame 之前）
+    void Finish();
+
+    void SetBudget(std::size_t budget_bytes);
+    std::size_t Budget() const;
+    std::size_t ResidentBytes() const;
+    const Stats& GetStats() const;
+
+private:
+    struct Entry {
+        std::string filename;
+        std::shared_ptr<Texture> texture;
+        std::uint64_t last_used = 0;
+        bool loading = false;
+        bool failed = false;  // 載入失敗的貼圖一直使用 placeholder，不會重試
+    };
+
+    TextureLoader m_loader;
+    TextureOptions m_options;
+    std::size_t m_budget;
+    std::size_t m_resident_bytes;
+    std::uint64_t m_frame;
+    GLuint m_placeholder;
+    std::vector<Entry> m_entries;
+    // TextureLoader 的 ticket 對應到哪個 entry
+    std::unordered_map<std::size_t, Handle> m_tickets;
+    Stats m_stats;
+
+    void Upload(TextureLoader::Result& result);
+    void MakeResident(Entry& entry, std::shared_ptr<Texture> texture);
+    void Evict();
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+struct ThreadPool {
+    explicit ThreadPool(unsigned int num_threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> job);
+    void Wait();
+    unsigned int Size() const;
+
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_job_available;
+    std::condition_variable m_all_done;
+    unsigned int m_running;
+    bool m_stopping;
+
+    void WorkerLoop();
+};
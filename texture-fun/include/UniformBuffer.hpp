@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 各個 uniform block 固定使用的 binding point，所有 program 共用。
+// 每個物件各自的資料（model matrix、texture layer）不走 UBO：QuadRenderer 把它們寫成 instance attribute
+// （instanced.vert 的 location 2~6），一整批 quad 只需要一次上傳與一個 draw call，比每次 draw 推進一格 ring buffer 更省
+enum UniformBinding : GLuint {
+    CameraBlock = 0,
+};
+
+// 由 Shader 在 link 之後查詢到的 uniform block 配置（std140 的 offset / stride）
+struct UniformBlockLayout {
+    struct Member {
+        GLint offset;
+        GLint array_stride;
+        GLint matrix_stride;
+        GLenum type;
+    };
+
+    std::string name;
+    GLuint index = GL_INVALID_INDEX;
+    GLint size = 0;
+    std::unordered_map<std::string, Member> members;
+
+    const Member* Find(const std::string& member_name) const;
+};
+
+// 每個 frame 更新一次、所有 program 共用的 UBO（例如相機的 view / projection）。
+// Set* 只寫入 CPU 端的副本，Upload 時才以一次 glBufferSubData 送出。
+struct UniformBuffer {
+    UniformBuffer(GLuint binding, const UniformBlockLayout& layout);
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    void SetInt(const std::string& member_name, int value);
+    void SetFloat(const std::string& member_name, float value);
+    void SetVec4(const std::string& member_name, const glm::vec4& vector);
+    void SetMat4(const std::string& member_name, const glm::mat4& matrix);
+
+    void Upload();
+
+private:
+    GLuint m_id;
+    GLuint m_binding;
+    UniformBlockLayout m_layout;
+    std::vector<unsigned char> m_data;
+    bool m_dirty;
+
+    unsigned char* MemberData(const std::string& member_name, GLenum type);
+};
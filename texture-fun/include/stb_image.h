@@ -428,6 +428,16 @@ STBIDEF stbi_uc *stbi_load_from_file  (FILE *f, int *x, int *y, int *channels_in
 
 #ifndef STBI_NO_GIF
 STBIDEF stbi_uc *stbi_load_gif_from_memory(stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp);
+
+// streaming variant of stbi_load_gif_from_memory: frames are composited one at a time
+// into a canvas owned by the stream, so memory stays bounded for long animations.
+// stbi_gif_stream_next returns the RGBA canvas (valid until the next call) or NULL at the
+// end of the animation / on error; the buffer must stay alive until the stream is closed.
+typedef struct stbi_gif_stream stbi_gif_stream;
+STBIDEF stbi_gif_stream *stbi_gif_stream_open_memory(stbi_uc const *buffer, int len, int *x, int *y);
+STBIDEF stbi_uc         *stbi_gif_stream_next       (stbi_gif_stream *stream, int *delay_ms);
+STBIDEF void             stbi_gif_stream_rewind     (stbi_gif_stream *stream);
+STBIDEF void             stbi_gif_stream_close      (stbi_gif_stream *stream);
 #endif
 
 #ifdef STBI_WINDOWS_UTF8
@@ -4590,6 +4600,120 @@ static int stbi__paeth(int a, int b, int c)
 
 static const stbi_uc stbi__depth_scale_table[9] = { 0, 0xff, 0x55, 0, 0x11, 0,0,0, 0x01 };
 
+#ifdef STBI_SSE2
+// SSE2 reconstruction of 8-bit RGB/RGBA scanlines, one pixel per vector
+// (same approach as libpng's filter_sse2_intrinsics.c). Sub/Avg/Paeth
+// depend on the pixel to the left, so we can't go wider than one pixel,
+// but we avoid the per-byte loop and branchy scalar Paeth.
+// 3-byte pixels are assembled in registers: a 3-byte memcpy into an int
+// goes through the stack and the following 4-byte read stalls on store
+// forwarding, which made RGB slower than the scalar loop
+static __m128i stbi__png_load_px(stbi_uc const *p, int bpp)
+{
+   int v;
+   if (bpp == 4) memcpy(&v, p, 4);
+   else          v = p[0] | (p[1] << 8) | (p[2] << 16);
+   return _mm_cvtsi32_si128(v);
+}
+
+static void stbi__png_store_px(stbi_uc *p, __m128i v, int bpp)
+{
+   int x = _mm_cvtsi128_si32(v);
+   if (bpp == 4) memcpy(p, &x, 4);
+   else {
+      p[0] = (stbi_uc) x;
+      p[1] = (stbi_uc) (x >> 8);
+      p[2] = (stbi_uc) (x >> 16);
+   }
+}
+
+static __m128i stbi__png_abs_epi16(__m128i x)
+{
+   return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+static __m128i stbi__png_select(__m128i mask, __m128i a, __m128i b)
+{
+   return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// filters 'pixels' pixels starting at cur (the pixel before cur is already
+// reconstructed); returns 0 if the caller should fall back to scalar code
+static int stbi__png_defilter_row_sse2(int filter, stbi_uc *cur, stbi_uc const *raw, stbi_uc const *prior, int bpp, int pixels)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i ones = _mm_set1_epi8(1);
+   __m128i a, b, c, d;
+   int i, n;
+
+   if (bpp != 3 && bpp != 4) return 0;
+
+   a = stbi__png_load_px(cur - bpp, bpp);
+   switch (filter) {
+      case STBI__F_up:
+         n = pixels * bpp;
+         for (i=0; i+16 <= n; i += 16) {
+            __m128i r = _mm_loadu_si128((__m128i const *) (raw + i));
+            __m128i p = _mm_loadu_si128((__m128i const *) (prior + i));
+            _mm_storeu_si128((__m128i *) (cur + i), _mm_add_epi8(r, p));
+         }
+         for (; i < n; ++i)
+            cur[i] = STBI__BYTECAST(raw[i] + prior[i]);
+         return 1;
+
+      case STBI__F_sub:
+      case STBI__F_paeth_first: // paeth(a,0,0) is always a
+         for (i=0; i < pixels; ++i, raw += bpp, cur += bpp) {
+            a = _mm_add_epi8(a, stbi__png_load_px(raw, bpp));
+            stbi__png_store_px(cur, a, bpp);
+         }
+         return 1;
+
+      case STBI__F_avg:
+      case STBI__F_avg_first:
+         b = zero;
+         for (i=0; i < pixels; ++i, raw += bpp, cur += bpp) {
+            __m128i avg;
+            if (filter == STBI__F_avg) {
+               b = stbi__png_load_px(prior, bpp);
+               prior += bpp;
+            }
+            // pavgb rounds up; subtract the carry to get floor((a+b)/2)
+            avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), ones));
+            a = _mm_add_epi8(avg, stbi__png_load_px(raw, bpp));
+            stbi__png_store_px(cur, a, bpp);
+         }
+         return 1;
+
+      case STBI__F_paeth:
+         a = _mm_unpacklo_epi8(a, zero);
+         c = _mm_unpacklo_epi8(stbi__png_load_px(prior - bpp, bpp), zero);
+         for (i=0; i < pixels; ++i, raw += bpp, cur += bpp, prior += bpp) {
+            __m128i pa, pb, pc, smallest, nearest;
+            b = _mm_unpacklo_epi8(stbi__png_load_px(prior, bpp), zero);
+            d = _mm_unpacklo_epi8(stbi__png_load_px(raw, bpp), zero);
+            // p = a+b-c, so p-a = b-c, p-b = a-c and p-c = (b-c)+(a-c)
+            pa = _mm_sub_epi16(b, c);
+            pb = _mm_sub_epi16(a, c);
+            pc = stbi__png_abs_epi16(_mm_add_epi16(pa, pb));
+            pa = stbi__png_abs_epi16(pa);
+            pb = stbi__png_abs_epi16(pb);
+            smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+            // ties favor a over b over c, same as stbi__paeth
+            nearest = stbi__png_select(_mm_cmpeq_epi16(smallest, pa), a,
+                      stbi__png_select(_mm_cmpeq_epi16(smallest, pb), b, c));
+            // 8-bit add so the sum wraps mod 256; the high bytes stay zero
+            a = _mm_add_epi8(d, nearest);
+            stbi__png_store_px(cur, _mm_packus_epi16(a, a), bpp);
+            c = b;
+         }
+         return 1;
+   }
+   return 0;
+}
+#endif // STBI_SSE2
+
+
 // create the png data from post-deflated data
 static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 raw_len, int out_n, stbi__uint32 x, stbi__uint32 y, int depth, int color)
 {
@@ -4675,6 +4799,9 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
          #define STBI__CASE(f) \
              case f:     \
                 for (k=0; k < nk; ++k)
+#ifdef STBI_SSE2
+         if (depth != 8 || !stbi__png_defilter_row_sse2(filter, cur, raw, prior, filter_bytes, width - 1))
+#endif
          switch (filter) {
             // "none" filter turns into a memcpy here; make that explicit.
             case STBI__F_none:         memcpy(cur, raw, nk); break;
@@ -5140,8 +5267,14 @@ static int stbi__parse_png_file(stbi__png *z, int scan, int req_comp)
             // initial guess for decoded data size to avoid unnecessary reallocs
             bpl = (s->img_x * z->depth + 7) / 8; // bytes per line, per component
             raw_len = bpl * s->img_y * s->img_n /* pixels */ + s->img_y /* filter mode per row */;
+#ifdef STBI_ZLIB_DECODE_OVERRIDE
+            // pluggable inflate backend: same signature as stbi_zlib_decode_malloc_guesssize_headerflag, result freed with STBI_FREE
+            z->expanded = (stbi_uc *) STBI_ZLIB_DECODE_OVERRIDE((char *) z->idata, ioff, raw_len, (int *) &raw_len, !is_iphone);
+            if (z->expanded == NULL) return stbi__err("bad zlib","Corrupt PNG");
+#else
             z->expanded = (stbi_uc *) stbi_zlib_decode_malloc_guesssize_headerflag((char *) z->idata, ioff, raw_len, (int *) &raw_len, !is_iphone);
             if (z->expanded == NULL) return 0; // zlib should set error
+#endif
             STBI_FREE(z->idata); z->idata = NULL;
             if ((req_comp == s->img_n+1 && req_comp != 3 && !pal_img_n) || has_trans)
                s->img_out_n = s->img_n+1;
@@ -7000,6 +7133,86 @@ static int stbi__gif_info(stbi__context *s, int *x, int *y, int *comp)
 {
    return stbi__gif_info_raw(s,x,y,comp);
 }
+
+struct stbi_gif_stream
+{
+   stbi__context s;
+   stbi__gif g;
+   stbi_uc const *buffer;
+   int len;
+   int frames;          // frames decoded since the last rewind
+   stbi_uc *previous;   // the two most recent composited frames, for "restore to previous" disposal
+   stbi_uc *two_back;
+};
+
+static void stbi__gif_stream_reset(stbi_gif_stream *stream)
+{
+   STBI_FREE(stream->g.out);
+   STBI_FREE(stream->g.history);
+   STBI_FREE(stream->g.background);
+   memset(&stream->g, 0, sizeof(stream->g));
+   stbi__start_mem(&stream->s, stream->buffer, stream->len);
+   stream->frames = 0;
+}
+
+STBIDEF stbi_gif_stream *stbi_gif_stream_open_memory(stbi_uc const *buffer, int len, int *x, int *y)
+{
+   stbi_gif_stream *stream;
+   stbi__context s;
+   int comp;
+   stbi__start_mem(&s, buffer, len);
+   if (!stbi__gif_info_raw(&s, x, y, &comp)) return (stbi_gif_stream *) stbi__errpuc("not GIF", "Image was not as a gif type.");
+   if (!stbi__mad3sizes_valid(4, *x, *y, 0)) return (stbi_gif_stream *) stbi__errpuc("too large", "GIF image is too large");
+
+   stream = (stbi_gif_stream *) stbi__malloc(sizeof(stbi_gif_stream));
+   if (!stream) return (stbi_gif_stream *) stbi__errpuc("outofmem", "Out of memory");
+   memset(stream, 0, sizeof(*stream));
+   stream->buffer = buffer;
+   stream->len = len;
+   stream->previous = (stbi_uc *) stbi__malloc_mad3(4, *x, *y, 0);
+   stream->two_back = (stbi_uc *) stbi__malloc_mad3(4, *x, *y, 0);
+   if (!stream->previous || !stream->two_back) {
+      stbi_gif_stream_close(stream);
+      return (stbi_gif_stream *) stbi__errpuc("outofmem", "Out of memory");
+   }
+   stbi__gif_stream_reset(stream);
+   return stream;
+}
+
+STBIDEF stbi_uc *stbi_gif_stream_next(stbi_gif_stream *stream, int *delay_ms)
+{
+   int comp;
+   stbi_uc *u;
+   stbi_uc *t;
+   u = stbi__gif_load_next(&stream->s, &stream->g, &comp, 4, stream->frames >= 2 ? stream->two_back : 0);
+   if (u == (stbi_uc *) &stream->s || u == 0) return 0; // end of animated gif marker, or error
+
+   // keep the composited frame around: the frame after next may want to revert to it
+   t = stream->two_back;
+   stream->two_back = stream->previous;
+   stream->previous = t;
+   memcpy(stream->previous, u, 4 * stream->g.w * stream->g.h);
+
+   ++stream->frames;
+   if (delay_ms) *delay_ms = stream->g.delay;
+   return u;
+}
+
+STBIDEF void stbi_gif_stream_rewind(stbi_gif_stream *stream)
+{
+   stbi__gif_stream_reset(stream);
+}
+
+STBIDEF void stbi_gif_stream_close(stbi_gif_stream *stream)
+{
+   if (!stream) return;
+   STBI_FREE(stream->g.out);
+   STBI_FREE(stream->g.history);
+   STBI_FREE(stream->g.background);
+   STBI_FREE(stream->previous);
+   STBI_FREE(stream->two_back);
+   STBI_FREE(stream);
+}
 #endif
 
 // *************************************************************************************************
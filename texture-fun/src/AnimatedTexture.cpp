@@ -0,0 +1,407 @@
+#include "AnimatedTexture.hpp"
+
+#include "GLFeatures.hpp"
+#include "Mipmap.hpp"
+#include "PixelUploader.hpp"
+#include "Profiler.hpp"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// 瀏覽器會把太短的延遲當成 100ms 播放，這裡採用相同的規則
+static int NormalizeDelay(int delay_ms) {
+    return delay_ms <= 10 ? 100 : delay_ms;
+}
+
+// 只走過 GIF 的 block 結構（不解壓縮 LZW 資料），讀出影格數與每張影格的延遲時間
+static bool ScanGif(const std::vector<unsigned char>& file, std::vector<int>& delays) {
+    const unsigned char* p = file.data();
+    const unsigned char* end = p + file.size();
+
+    auto skip_sub_blocks = [&]() {
+        while (p < end) {
+            unsigned char size = *p++;
+            if (size == 0) {
+                return true;
+            }
+            p += size;
+        }
+        return false;
+    };
+
+    if (end - p < 13 || std::memcmp(p, "GIF8", 4) != 0) {
+        return false;
+    }
+    unsigned char flags = p[10];
+    p += 13;
+    if (flags & 0x80) {
+        p += 3 * (2 << (flags & 7));
+    }
+
+    // 與 stb_image 相同，沒有 Graphic Control Extension 的影格沿用前一張的延遲時間
+    int delay = 0;
+    while (p < end) {
+        switch (*p++) {
+            case 0x21: {
+                if (end - p >= 5 && p[0] == 0xF9 && p[1] == 4) {
+                    delay = 10 * (p[3] | (p[4] << 8));
+                }
+                if (end - p < 1) {
+                    return false;
+                }
+                ++p;
+                if (!skip_sub_blocks()) {
+                    return false;
+                }
+            } break;
+            case 0x2C: {
+                if (end - p < 9) {
+                    return false;
+                }
+                unsigned char image_flags = p[8];
+                p += 9;
+                if (image_flags & 0x80) {
+                    p += 3 * (2 << (image_flags & 7));
+                }
+                // LZW minimum code size
+                ++p;
+                if (p > end || !skip_sub_blocks()) {
+                    return false;
+                }
+                delays.push_back(NormalizeDelay(delay));
+            } break;
+            case 0x3B:
+                return !delays.empty();
+            default:
+                return false;
+        }
+    }
+    return !delays.empty();
+}
+
+AnimatedTexture::AnimatedTexture(ThreadPool& pool, const std::string& filename, const TextureOptions& options, int lookahead) :
+    id(0),
+    width(0),
+    height(0),
+    frames(0),
+    m_pool(pool),
+    m_options(options),
+    m_lookahead(static_cast<std::size_t>(std::max(lookahead, 1))),
+    m_stream(nullptr),
+    m_next_index(0),
+    m_decoding(false),
+    m_failed(false),
+    m_current(-1) {
+    std::ifstream file(filename, std::ios::binary);
+    m_file.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    if (m_file.empty() || !ScanGif(m_file, delays)) {
+        std::cout << "Failed to load animated texture: " << filename << std::endl;
+        exit(-42069);
+    }
+    m_stream = stbi_gif_stream_open_memory(m_file.data(), static_cast<int>(m_file.size()), &width, &height);
+    if (m_stream == nullptr) {
+        std::cout << "Failed to load animated texture: " << filename << " (" << stbi_failure_reason() << ")" << std::endl;
+        exit(-42069);
+    }
+
+    frames = static_cast<int>(delays.size());
+    m_start_times.resize(delays.size() + 1, 0);
+    for (std::size_t i = 0; i < delays.size(); ++i) {
+        m_start_times[i + 1] = m_start_times[i] + delays[i];
+    }
+
+    // 先配置好每個 mip level 的空間，之後每次切換影格只需要 glTexSubImage2D
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+
+    int levels = mipmap::LevelCount(width, height);
+    if (m_options.immutable_storage && gl_features::TextureStorage()) {
+        glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, width, height);
+    } else {
+        for (int level = 0, w = width, h = height; level < levels; ++level) {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            w = std::max(1, w / 2);
+            h = std::max(1, h / 2);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    }
+
+    // 一張影格在 staging 中的配置：level 0 之後緊接著 CPU 產生的 mip chain（交給 glGenerateMipmap 時只有 level 0）
+    int cpu_levels = m_options.mipmap_filter == MipmapFilter::Driver ? 1 : levels;
+    m_frame_bytes = 0;
+    for (int level = 0, w = width, h = height; level < cpu_levels; ++level) {
+        m_levels.push_back({ w, h, m_frame_bytes });
+        m_frame_bytes += static_cast<std::size_t>(w) * h * 4;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    m_mips.resize(m_frame_bytes - static_cast<std::size_t>(width) * height * 4);
+
+    // 多留一點空間給 PixelUploader 的 64 byte 對齊；ring 可以讀回，mip chain 才能直接從 staging 中的上一層產生
+    m_uploader = std::make_unique<PixelUploader>((m_lookahead + 2) * (m_frame_bytes + 64), true);
+    m_uploader->enabled = PixelUploader::Default().enabled;
+    if (m_uploader->enabled) {
+        m_uploader->Initialize();
+    }
+
+    // 第一張影格不能等背景解碼，否則一開始會顯示未初始化的貼圖
+    Frame frame;
+    if (m_uploader->IsPersistent()) {
+        frame.staging = m_uploader->Allocate(m_frame_bytes);
+    }
+    if (!DecodeNext(-1, frame)) {
+        std::cout << "Failed to load animated texture: " << filename << " (" << stbi_failure_reason() << ")" << std::endl;
+        exit(-42069);
+    }
+    Upload(frame);
+    m_current = frame.index;
+    Recycle(frame);
+}
+
+AnimatedTexture::~AnimatedTexture() {
+    // 解碼工作會用到 m_stream 與 this，必須等它結束
+    m_pool.Wait();
+    stbi_gif_stream_close(m_stream);
+    glDeleteTextures(1, &id);
+}
+
+void AnimatedTexture::Update(float time) {
+    Frame frame;
+    while (m_completed.TryPop(frame)) {
+        m_decoding = false;
+        if (frame.index < 0) {
+            m_failed = true;
+        } else {
+            m_decoded.push_back(std::move(frame));
+        }
+    }
+
+    int target = FrameAt(time);
+    if (target != m_current) {
+        // GIF 的影格彼此相依，只能依序往後解碼；播到結尾時會從頭開始，所以「往回」也是往後走到下一輪。
+        // 目標之前的影格直接丟掉，不上傳也不產生 mipmap
+        while (!m_decoded.empty()) {
+            Frame& front = m_decoded.front();
+            bool found = front.index == target;
+            if (found) {
+                Upload(front);
+                m_current = target;
+            }
+            Recycle(front);
+            m_decoded.pop_front();
+            if (found) {
+                break;
+            }
+        }
+    }
+
+    if (m_decoding || m_failed) {
+        return;
+    }
+    if (target != m_current && m_decoded.empty()) {
+        // 已經落後超過 lookahead：在 worker 上一路跳到目標，中間的影格不必送回來
+        DecodeAsync(target);
+    } else if (m_decoded.size() < m_lookahead) {
+        DecodeAsync(-1);
+    }
+}
+
+void AnimatedTexture::Bind() {
+    glBindTexture(GL_TEXTURE_2D, id);
+}
+
+int AnimatedTexture::CurrentFrame() const {
+    return m_current;
+}
+
+float AnimatedTexture::Duration() const {
+    return static_cast<float>(m_start_times.back()) / 1000.0f;
+}
+
+int AnimatedTexture::FrameAt(float time) const {
+    long long duration = m_start_times.back();
+    long long ms = static_cast<long long>(std::max(time, 0.0f) * 1000.0f) % duration;
+    auto it = std::upper_bound(m_start_times.begin(), m_start_times.end(), ms);
+    return static_cast<int>(it - m_start_times.begin()) - 1;
+}
+
+void AnimatedTexture::DecodeAsync(int wanted) {
+    // persistent ring 的空間在 Submit 之前就可以交給 worker 寫入；orphaning 時只能在上傳前才 map，先解碼到 client memory
+    Frame frame;
+    if (m_uploader->IsPersistent()) {
+        frame.staging = m_uploader->Allocate(m_frame_bytes);
+    }
+    if (frame.staging.data == nullptr && !m_free_pixels.empty()) {
+        frame.pixels = std::move(m_free_pixels.back());
+        m_free_pixels.pop_back();
+    }
+
+    m_decoding = true;
+    m_pool.Submit([this, wanted, frame = std::move(frame)]() mutable {
+        if (!DecodeNext(wanted, frame)) {
+            frame.index = -1;
+        }
+        m_completed.Push(std::move(frame));
+    });
+}
+
+bool AnimatedTexture::DecodeNext(int wanted, Frame& frame) {
+    PROFILE_ZONE("Decode GIF frame");
+    stbi_uc* canvas = nullptr;
+    for (int decoded = 0; decoded <= frames; ++decoded) {
+        int delay = 0;
+        canvas = stbi_gif_stream_next(m_stream, &delay);
+        if (canvas == nullptr) {
+            // 播到結尾（或檔案在影格中間損毀）就從頭再來一次
+            stbi_gif_stream_rewind(m_stream);
+            m_next_index = 0;
+            canvas = stbi_gif_stream_next(m_stream, &delay);
+            if (canvas == nullptr) {
+                return false;
+            }
+        }
+
+        frame.index = m_next_index;
+        m_next_index = (m_next_index + 1) % frames;
+        if (wanted < 0 || frame.index == wanted) {
+            break;
+        }
+    }
+
+    // canvas 在下一次解碼時會被覆寫，所以複製一份；同時上下翻轉，與 Image 的方向一致
+    std::size_t stride = static_cast<std::size_t>(width) * 4;
+    unsigned char* pixels = frame.staging.data;
+    if (pixels == nullptr) {
+        frame.pixels.resize(stride * height);
+        pixels = frame.pixels.data();
+    }
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(pixels + stride * (height - 1 - y), canvas + stride * y, stride);
+    }
+    return true;
+}
+
+// 經由 PBO ring 上傳，GL 不必在這裡同步複製整張影格，串流播放時才不會造成 frame time 突波
+void AnimatedTexture::Upload(const Frame& frame) {
+    PROFILE_ZONE("Upload GIF frame");
+    glBindTexture(GL_TEXTURE_2D, id);
+
+    // worker 沒有 staging 可寫（orphaning）時才在這裡取得空間並複製過去
+    PixelUploader::Staging staging = frame.staging;
+    if (staging.data == nullptr) {
+        staging = m_uploader->Allocate(m_frame_bytes);
+        if (staging.data != nullptr) {
+            std::memcpy(staging.data, frame.pixels.data(), frame.pixels.size());
+        }
+    }
+
+    // 只替真正顯示的影格產生 mip chain
+    if (m_options.mipmap_filter != MipmapFilter::Driver) {
+        GenerateMipmaps(frame, staging);
+    }
+
+    if (staging.data == nullptr) {
+        // --no-upload-ring：直接從 client memory 上傳
+        SetUnpackAlignment(width, 4);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, frame.pixels.data());
+        for (std::size_t level = 1; level < m_levels.size(); ++level) {
+            SetUnpackAlignment(m_levels[level].width, 4);
+            glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0, m_levels[level].width, m_levels[level].height, GL_RGBA,
+                GL_UNSIGNED_BYTE, m_mips.data() + m_levels[level].offset - m_levels[1].offset);
+        }
+    } else {
+        for (std::size_t level = 0; level < m_levels.size(); ++level) {
+            SetUnpackAlignment(m_levels[level].width, 4);
+            m_uploader->TexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), m_levels[level].width, m_levels[level].height, GL_RGBA,
+                GL_UNSIGNED_BYTE, staging, m_levels[level].offset);
+        }
+        m_uploader->Submit(staging);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (m_options.mipmap_filter == MipmapFilter::Driver) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+}
+
+void AnimatedTexture::GenerateMipmaps(const Frame& frame, const PixelUploader::Staging& staging) {
+    if (m_levels.size() < 2) {
+        return;
+    }
+
+    // 可以讀回的 persistent ring：每一層直接從 staging 中的上一層縮小，不經過 client memory
+    if (staging.data != nullptr && m_uploader->CanRead()) {
+        for (std::size_t level = 1; level < m_levels.size(); ++level) {
+            const Level& src = m_levels[level - 1];
+            mipmap::Downsample(staging.data + src.offset, src.width, src.height, 4, staging.data + m_levels[level].offset,
+                m_options.mipmap_filter);
+        }
+        return;
+    }
+
+    // orphaning 的 mapping 只能寫：在 m_mips 中產生，有 staging 時再一次複製過去
+    const unsigned char* src = frame.pixels.data();
+    for (std::size_t level = 1; level < m_levels.size(); ++level) {
+        unsigned char* dst = m_mips.data() + m_levels[level].offset - m_levels[1].offset;
+        mipmap::Downsample(src, m_levels[level - 1].width, m_levels[level - 1].height, 4, dst, m_options.mipmap_filter);
+        src = dst;
+    }
+    if (staging.data != nullptr) {
+        std::memcpy(staging.data + m_levels[1].offset, m_mips.data(), m_mips.size());
+    }
+}
+
+void AnimatedTexture::Recycle(Frame& frame) {
+    if (!frame.pixels.empty() && m_free_pixels.size() < m_lookahead) {
+        m_free_pixels.push_back(std::move(frame.pixels));
+    }
+}
+
+bool LoadGifFrames(const std::string& filename, std::vector<Image>& images, std::vector<int>& delays) {
+    PROFILE_ZONE("Decode GIF");
+    images.clear();
+    delays.clear();
+
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.empty() || !ScanGif(data, delays)) {
+        return false;
+    }
+
+    int width = 0;
+    int height = 0;
+    stbi_gif_stream* stream = stbi_gif_stream_open_memory(data.data(), static_cast<int>(data.size()), &width, &height);
+    if (stream == nullptr) {
+        return false;
+    }
+
+    std::size_t stride = static_cast<std::size_t>(width) * 4;
+    for (std::size_t i = 0; i < delays.size(); ++i) {
+        int delay = 0;
+        stbi_uc* canvas = stbi_gif_stream_next(stream, &delay);
+        if (canvas == nullptr) {
+            break;
+        }
+
+        std::shared_ptr<unsigned char> pixels(new unsigned char[stride * height], std::default_delete<unsigned char[]>());
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(pixels.get() + stride * (height - 1 - y), canvas + stride * y, stride);
+        }
+
+        Image image;
+        image.width = width;
+        image.height = height;
+        image.channels = 4;
+        image.pixels = std::move(pixels);
+        images.push_back(std::move(image));
+    }
+    stbi_gif_stream_close(stream);
+
+    // 檔案在影格中間損毀時只保留解碼成功的部分
+    delays.resize(images.size());
+    return !images.empty();
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+
+namespace {
+    // nearest-rank：排序後第 ceil(p * n) 個
+    float Percentile(const std::vector<float>& sorted, float p) {
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+    }
+
+    std::string Escape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    void WriteStats(std::ostream& out, const char* name, const FrameStats& stats) {
+        out << "  \"" << name << "\": {\"count\": " << stats.count << ", \"mean\": " << stats.mean
+            << ", \"p50\": " << stats.p50 << ", \"p95\": " << stats.p95 << ", \"p99\": " << stats.p99
+            << ", \"max\": " << stats.max << "}";
+    }
+
+    // 報告是自己寫出來的固定格式，只要找到 "section" 之後的第一個 "key" 就好，不需要完整的 JSON parser
+    bool ReadValue(const std::string& json, const std::string& section, const std::string& key, float& value) {
+        std::size_t position = json.find("\"" + section + "\"");
+        if (position == std::string::npos) {
+            return false;
+        }
+        position = json.find("\"" + key + "\":", position);
+        if (position == std::string::npos) {
+            return false;
+        }
+        const char* start = json.c_str() + position + key.size() + 3;
+        char* end = nullptr;
+        value = std::strtof(start, &end);
+        return end != start;
+    }
+
+    bool Compare(const char* name, float baseline, float current, float threshold) {
+        float change = baseline > 0.0f ? (current - baseline) / baseline : 0.0f;
+        bool passed = change <= threshold;
+        std::cout << name << " p95: " << current << " ms (baseline " << baseline << " ms, "
+                  << (change >= 0.0f ? "+" : "") << change * 100.0f << "%)" << (passed ? "" : " REGRESSION")
+                  << std::endl;
+        return passed;
+    }
+}
+
+FrameStats FrameStats::From(const std::vector<float>& samples, std::size_t skip) {
+    FrameStats stats;
+    if (samples.size() <= skip) {
+        return stats;
+    }
+
+    std::vector<float> sorted(samples.begin() + skip, samples.end());
+    std::sort(sorted.begin(), sorted.end());
+    stats.count = sorted.size();
+    stats.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0f) / sorted.size();
+    stats.p50 = Percentile(sorted, 0.50f);
+    stats.p95 = Percentile(sorted, 0.95f);
+    stats.p99 = Percentile(sorted, 0.99f);
+    stats.max = sorted.back();
+    return stats;
+}
+
+namespace benchmark {
+    void FollowCameraPath(Camera& camera, float time) {
+        float sweep = std::sin(time * 0.4f);
+        camera.Position = glm::vec3(12.0f * sweep, 6.0f + 3.0f * std::sin(time * 0.25f), 22.0f + 8.0f * std::cos(time * 0.4f));
+        camera.Yaw = -35.0f * sweep;
+        camera.Pitch = -5.0f;
+        camera.Roll = 0.0f;
+        camera.Velocity = glm::vec3(0.0f);
+        camera.Acceleration = glm::vec3(0.0f);
+    }
+
+    void Print(const char* name, const FrameStats& stats) {
+        if (stats.count == 0) {
+            return;
+        }
+        std::cout << name << " (" << stats.count << " frames): p50 " << stats.p50 << " ms, p95 " << stats.p95
+                  << " ms, p99 " << stats.p99 << " ms, max " << stats.max << " ms" << std::endl;
+    }
+
+    bool WriteJson(const std::string& filename, const Report& report) {
+        std::ofstream file(filename);
+        if (!file) {
+            std::cout << "Failed to write benchmark report: " << filename << std::endl;
+            return false;
+        }
+
+        file << "{\n"
+             << "  \"renderer\": \"" << Escape(report.renderer) << "\",\n"
+             << "  \"frames\": " << report.frames << ",\n"
+             << "  \"quads\": " << report.quads << ",\n";
+        WriteStats(file, "frame_ms", report.frame);
+        file << ",\n";
+        WriteStats(file, "cpu_ms", report.cpu);
+        file << ",\n";
+        WriteStats(file, "gpu_ms", report.gpu);
+        file << "\n}\n";
+        return static_cast<bool>(file);
+    }
+
+    bool CompareWithBaseline(const std::string& filename, const Report& report, float threshold) {
+        std::ifstream file(filename);
+        if (!file) {
+            std::cout << "Failed to read benchmark baseline: " << filename << std::endl;
+            return false;
+        }
+        std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        float cpu = 0.0f;
+        if (!ReadValue(json, "cpu_ms", "p95", cpu)) {
+            std::cout << "Benchmark baseline has no CPU timings: " << filename << std::endl;
+            return false;
+        }
+        bool passed = Compare("CPU time", cpu, report.cpu.p95, threshold);
+
+        // 沒有 GPU 數據的 baseline（或這次沒有量到）只比較 CPU
+        float gpu = 0.0f;
+        float gpu_count = 0.0f;
+        if (report.gpu.count > 0 && ReadValue(json, "gpu_ms", "count", gpu_count) && gpu_count > 0.0f &&
+            ReadValue(json, "gpu_ms", "p95", gpu)) {
+            passed = Compare("GPU time", gpu, report.gpu.p95, threshold) && passed;
+        }
+        return passed;
+    }
+}
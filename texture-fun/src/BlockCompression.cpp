@@ -0,0 +1,402 @@
+#include "BlockCompression.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BCN_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // 一個 4x4 block，顏色以 SoA 的 float 存放，方便一次比較 4 個像素
+    struct Block {
+        alignas(16) float r[16];
+        alignas(16) float g[16];
+        alignas(16) float b[16];
+        std::uint8_t a[16];
+    };
+
+    void LoadBlock(const unsigned char* rgba, int width, int height, int block_x, int block_y, Block& block) {
+        for (int y = 0; y < 4; ++y) {
+            int sy = std::min(block_y * 4 + y, height - 1);
+            for (int x = 0; x < 4; ++x) {
+                int sx = std::min(block_x * 4 + x, width - 1);
+                const unsigned char* p = rgba + (static_cast<std::size_t>(sy) * width + sx) * 4;
+                block.r[y * 4 + x] = p[0];
+                block.g[y * 4 + x] = p[1];
+                block.b[y * 4 + x] = p[2];
+                block.a[y * 4 + x] = p[3];
+            }
+        }
+    }
+
+    std::uint16_t Pack565(const float color[3]) {
+        int r = std::clamp(static_cast<int>(color[0] * (31.0f / 255.0f) + 0.5f), 0, 31);
+        int g = std::clamp(static_cast<int>(color[1] * (63.0f / 255.0f) + 0.5f), 0, 63);
+        int b = std::clamp(static_cast<int>(color[2] * (31.0f / 255.0f) + 0.5f), 0, 31);
+        return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    // 展開回 8 bits 時重複最高的幾個 bit，跟硬體一致
+    void Unpack565(std::uint16_t value, int color[3]) {
+        int r = (value >> 11) & 31;
+        int g = (value >> 5) & 63;
+        int b = value & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    // 4 色模式的調色盤：c0、c1、2/3 c0 + 1/3 c1、1/3 c0 + 2/3 c1
+    void Palette(std::uint16_t c0, std::uint16_t c1, int palette[4][3]) {
+        Unpack565(c0, palette[0]);
+        Unpack565(c1, palette[1]);
+        for (int i = 0; i < 3; ++i) {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        }
+    }
+
+    // 替每個像素選最接近的調色盤顏色，回傳平方誤差的總和
+    float SelectIndices(const Block& block, const int palette[4][3], std::uint32_t& indices) {
+        indices = 0;
+        float error = 0.0f;
+#ifdef BCN_SSE2
+        for (int group = 0; group < 4; ++group) {
+            __m128 r = _mm_load_ps(block.r + group * 4);
+            __m128 g = _mm_load_ps(block.g + group * 4);
+            __m128 b = _mm_load_ps(block.b + group * 4);
+            __m128 best = _mm_set1_ps(1e30f);
+            __m128i best_index = _mm_setzero_si128();
+            for (int i = 0; i < 4; ++i) {
+                __m128 dr = _mm_sub_ps(r, _mm_set1_ps(static_cast<float>(palette[i][0])));
+                __m128 dg = _mm_sub_ps(g, _mm_set1_ps(static_cast<float>(palette[i][1])));
+                __m128 db = _mm_sub_ps(b, _mm_set1_ps(static_cast<float>(palette[i][2])));
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+                __m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+                best = _mm_min_ps(distance, best);
+                best_index = _mm_or_si128(_mm_andnot_si128(closer, best_index), _mm_and_si128(closer, _mm_set1_epi32(i)));
+            }
+
+            alignas(16) float distances[4];
+            alignas(16) std::int32_t selected[4];
+            _mm_store_ps(distances, best);
+            _mm_store_si128(reinterpret_cast<__m128i*>(selected), best_index);
+            for (int i = 0; i < 4; ++i) {
+                error += distances[i];
+                indices |= static_cast<std::uint32_t>(selected[i]) << ((group * 4 + i) * 2);
+            }
+        }
+#else
+        for (int p = 0; p < 16; ++p) {
+            float best = 1e30f;
+            std::uint32_t best_index = 0;
+            for (int i = 0; i < 4; ++i) {
+                float dr = block.r[p] - palette[i][0];
+                float dg = block.g[p] - palette[i][1];
+                float db = block.b[p] - palette[i][2];
+                float distance = dr * dr + dg * dg + db * db;
+                if (distance < best) {
+                    best = distance;
+                    best_index = static_cast<std::uint32_t>(i);
+                }
+            }
+            error += best;
+            indices |= best_index << (p * 2);
+        }
+#endif
+        return error;
+    }
+
+    float Evaluate(const Block& block, std::uint16_t c0, std::uint16_t c1, std::uint32_t& indices) {
+        int palette[4][3];
+        Palette(c0, c1, palette);
+        return SelectIndices(block, palette, indices);
+    }
+
+    // 固定 indices，以最小平方法求出最貼近的兩個端點（每個 index 對應 c0 的權重為 1、0、2/3、1/3）
+    bool RefineEndpoints(const Block& block, std::uint32_t indices, float e0[3], float e1[3]) {
+        static const float kWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+        float ap[3] = {};
+        float bp[3] = {};
+        for (int p = 0; p < 16; ++p) {
+            float w = kWeights[(indices >> (p * 2)) & 3];
+            float v = 1.0f - w;
+            aa += w * w;
+            bb += v * v;
+            ab += w * v;
+            const float color[3] = { block.r[p], block.g[p], block.b[p] };
+            for (int i = 0; i < 3; ++i) {
+                ap[i] += w * color[i];
+                bp[i] += v * color[i];
+            }
+        }
+
+        float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f) {
+            return false;
+        }
+        for (int i = 0; i < 3; ++i) {
+            e0[i] = std::clamp((ap[i] * bb - bp[i] * ab) / det, 0.0f, 255.0f);
+            e1[i] = std::clamp((bp[i] * aa - ap[i] * ab) / det, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    void EncodeColor(const Block& block, unsigned char* out) {
+        float mean[3] = {};
+        float low[3] = { 255.0f, 255.0f, 255.0f };
+        float high[3] = {};
+        for (int p = 0; p < 16; ++p) {
+            const float color[3] = { block.r[p], block.g[p], block.b[p] };
+            for (int i = 0; i < 3; ++i) {
+                mean[i] += color[i] / 16.0f;
+                low[i] = std::min(low[i], color[i]);
+                high[i] = std::max(high[i], color[i]);
+            }
+        }
+
+        // covariance 矩陣（對稱，只存 6 個元素）
+        float cov[6] = {};
+        for (int p = 0; p < 16; ++p) {
+            float d[3] = { block.r[p] - mean[0], block.g[p] - mean[1], block.b[p] - mean[2] };
+            cov[0] += d[0] * d[0];
+            cov[1] += d[0] * d[1];
+            cov[2] += d[0] * d[2];
+            cov[3] += d[1] * d[1];
+            cov[4] += d[1] * d[2];
+            cov[5] += d[2] * d[2];
+        }
+
+        // 以最大值減最小值當起點做幾次 power iteration，逼近 covariance 最大的特徵向量（顏色分布的主軸）
+        float axis[3] = { high[0] - low[0], high[1] - low[1], high[2] - low[2] };
+        for (int iteration = 0; iteration < 4; ++iteration) {
+            float next[3] = {
+                cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+                cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+                cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2],
+            };
+            float scale = std::max({ std::fabs(next[0]), std::fabs(next[1]), std::fabs(next[2]) });
+            if (scale < 1e-6f) {
+                break;
+            }
+            for (int i = 0; i < 3; ++i) {
+                axis[i] = next[i] / scale;
+            }
+        }
+
+        float e0[3] = { mean[0], mean[1], mean[2] };
+        float e1[3] = { mean[0], mean[1], mean[2] };
+        float length = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        if (length > 1e-6f) {
+            // 投影到主軸上的最小值與最大值就是兩個端點，再往內縮 1/16 讓內插的兩色更貼近中間的像素
+            float t_min = 1e30f;
+            float t_max = -1e30f;
+            for (int p = 0; p < 16; ++p) {
+                float t = ((block.r[p] - mean[0]) * axis[0] + (block.g[p] - mean[1]) * axis[1] + (block.b[p] - mean[2]) * axis[2]) / length;
+                t_min = std::min(t_min, t);
+                t_max = std::max(t_max, t);
+            }
+            float inset = (t_max - t_min) / 16.0f;
+            t_min += inset;
+            t_max -= inset;
+            for (int i = 0; i < 3; ++i) {
+                e0[i] = std::clamp(mean[i] + axis[i] * t_max, 0.0f, 255.0f);
+                e1[i] = std::clamp(mean[i] + axis[i] * t_min, 0.0f, 255.0f);
+            }
+        }
+
+        std::uint16_t c0 = Pack565(e0);
+        std::uint16_t c1 = Pack565(e1);
+        std::uint32_t indices = 0;
+        float error = Evaluate(block, c0, c1, indices);
+
+        float r0[3], r1[3];
+        if (c0 != c1 && RefineEndpoints(block, indices, r0, r1)) {
+            std::uint16_t refined0 = Pack565(r0);
+            std::uint16_t refined1 = Pack565(r1);
+            std::uint32_t refined_indices = 0;
+            float refined_error = Evaluate(block, refined0, refined1, refined_indices);
+            if (refined_error < error) {
+                c0 = refined0;
+                c1 = refined1;
+                indices = refined_indices;
+            }
+        }
+
+        // c0 > c1 才是 4 色模式，反過來時交換端點，index 0/1、2/3 也跟著對調；相等時只用 c0
+        if (c0 < c1) {
+            std::swap(c0, c1);
+            indices ^= 0x55555555u;
+        } else if (c0 == c1) {
+            indices = 0;
+        }
+
+        out[0] = static_cast<unsigned char>(c0 & 0xFF);
+        out[1] = static_cast<unsigned char>(c0 >> 8);
+        out[2] = static_cast<unsigned char>(c1 & 0xFF);
+        out[3] = static_cast<unsigned char>(c1 >> 8);
+        for (int i = 0; i < 4; ++i) {
+            out[4 + i] = static_cast<unsigned char>(indices >> (i * 8));
+        }
+    }
+
+    // a0 > a1 時為 8 階模式：a0、a1 與中間 6 個等分點
+    void AlphaPalette(int a0, int a1, int palette[8]) {
+        palette[0] = a0;
+        palette[1] = a1;
+        if (a0 > a1) {
+            for (int i = 1; i < 7; ++i) {
+                palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+            }
+        } else {
+            for (int i = 1; i < 5; ++i) {
+                palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    void EncodeAlpha(const Block& block, unsigned char* out) {
+        int a0 = *std::max_element(block.a, block.a + 16);
+        int a1 = *std::min_element(block.a, block.a + 16);
+
+        std::uint64_t indices = 0;
+        if (a0 != a1) {
+            int palette[8];
+            AlphaPalette(a0, a1, palette);
+            for (int p = 0; p < 16; ++p) {
+                int best = 0;
+                for (int i = 1; i < 8; ++i) {
+                    if (std::abs(block.a[p] - palette[i]) < std::abs(block.a[p] - palette[best])) {
+                        best = i;
+                    }
+                }
+                indices |= static_cast<std::uint64_t>(best) << (p * 3);
+            }
+        }
+
+        out[0] = static_cast<unsigned char>(a0);
+        out[1] = static_cast<unsigned char>(a1);
+        for (int i = 0; i < 6; ++i) {
+            out[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+        }
+    }
+
+    // BC1 的 c0 <= c1 為 3 色加透明的模式；BC3 的顏色部分一律是 4 色模式
+    void DecodeColor(const unsigned char* in, bool four_color_only, unsigned char out[16][4]) {
+        std::uint16_t c0 = static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+        std::uint16_t c1 = static_cast<std::uint16_t>(in[2] | (in[3] << 8));
+        int palette[4][4];
+        Unpack565(c0, palette[0]);
+        Unpack565(c1, palette[1]);
+        palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+        for (int i = 0; i < 3; ++i) {
+            if (four_color_only || c0 > c1) {
+                palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+                palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+            } else {
+                palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+                palette[3][i] = 0;
+            }
+        }
+        if (!four_color_only && c0 <= c1) {
+            palette[3][3] = 0;
+        }
+
+        std::uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<std::uint32_t>(in[7]) << 24);
+        for (int p = 0; p < 16; ++p) {
+            const int* color = palette[(indices >> (p * 2)) & 3];
+            for (int i = 0; i < 4; ++i) {
+                out[p][i] = static_cast<unsigned char>(color[i]);
+            }
+        }
+    }
+
+    void DecodeAlpha(const unsigned char* in, unsigned char out[16][4]) {
+        int palette[8];
+        AlphaPalette(in[0], in[1], palette);
+        std::uint64_t indices = 0;
+        for (int i = 0; i < 6; ++i) {
+            indices |= static_cast<std::uint64_t>(in[2 + i]) << (i * 8);
+        }
+        for (int p = 0; p < 16; ++p) {
+            out[p][3] = static_cast<unsigned char>(palette[(indices >> (p * 3)) & 7]);
+        }
+    }
+
+    void EncodeRows(bcn::Format format, const unsigned char* rgba, int width, int height, int first_row, int last_row, unsigned char* out) {
+        const int blocks_x = (width + 3) / 4;
+        const std::size_t block_bytes = bcn::BlockBytes(format);
+        Block block;
+        for (int by = first_row; by < last_row; ++by) {
+            for (int bx = 0; bx < blocks_x; ++bx) {
+                unsigned char* dst = out + (static_cast<std::size_t>(by) * blocks_x + bx) * block_bytes;
+                LoadBlock(rgba, width, height, bx, by, block);
+                if (format == bcn::Format::Bc3) {
+                    EncodeAlpha(block, dst);
+                    dst += 8;
+                }
+                EncodeColor(block, dst);
+            }
+        }
+    }
+}
+
+namespace bcn {
+    std::size_t BlockBytes(Format format) {
+        return format == Format::Bc1 ? 8 : 16;
+    }
+
+    std::size_t CompressedSize(Format format, int width, int height) {
+        return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+    }
+
+    void Encode(Format format, const unsigned char* rgba, int width, int height, unsigned char* out, ThreadPool* pool) {
+        const int blocks_y = (height + 3) / 4;
+        if (pool == nullptr || pool->Size() <= 1 || blocks_y < 2) {
+            EncodeRows(format, rgba, width, height, 0, blocks_y, out);
+            return;
+        }
+
+        // 每個 worker 分到幾段，讓負載不平均時也能互相補上
+        const int jobs = static_cast<int>(pool->Size()) * 4;
+        const int rows_per_job = std::max(1, (blocks_y + jobs - 1) / jobs);
+        for (int first = 0; first < blocks_y; first += rows_per_job) {
+            int last = std::min(blocks_y, first + rows_per_job);
+            pool->Submit([=] { EncodeRows(format, rgba, width, height, first, last, out); });
+        }
+        pool->Wait();
+    }
+
+    void Decode(Format format, const unsigned char* blocks, int width, int height, unsigned char* rgba) {
+        const int blocks_x = (width + 3) / 4;
+        const int blocks_y = (height + 3) / 4;
+        const std::size_t block_bytes = BlockBytes(format);
+        unsigned char texels[16][4];
+        for (int by = 0; by < blocks_y; ++by) {
+            for (int bx = 0; bx < blocks_x; ++bx) {
+                const unsigned char* src = blocks + (static_cast<std::size_t>(by) * blocks_x + bx) * block_bytes;
+                if (format == Format::Bc3) {
+                    DecodeColor(src + 8, true, texels);
+                    DecodeAlpha(src, texels);
+                } else {
+                    DecodeColor(src, false, texels);
+                }
+
+                for (int y = 0; y < 4 && by * 4 + y < height; ++y) {
+                    for (int x = 0; x < 4 && bx * 4 + x < width; ++x) {
+                        unsigned char* dst = rgba + (static_cast<std::size_t>(by * 4 + y) * width + bx * 4 + x) * 4;
+                        std::memcpy(dst, texels[y * 4 + x], 4);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -1,7 +1,10 @@
 #include "Camera.hpp"
+#include "MatrixMath.hpp"
 
 #include "SDL.h"
 
+#include <cmath>
+
 Camera::Camera(glm::vec3 pos, bool is_prscpt) :
     Pitch(0.0f),
     Yaw(0.0f),
@@ -21,6 +24,8 @@ Camera::Camera(glm::vec3 pos, bool is_prscpt) :
     FollowTarget(false) {
     WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
     UpdateCameraVectors();
+    PreviousPosition = Position;
+    RenderPosition = Position;
 
     // Default Value
     frustum.near = 0.1f;
@@ -49,6 +54,8 @@ Camera::Camera(glm::vec3 pos, glm::vec3 target, bool is_prscpt) :
     WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
     Distance = glm::length(Position - Target);
     UpdateCameraVectors();
+    PreviousPosition = Position;
+    RenderPosition = Position;
 
     // Default Value
     frustum.near = 0.1f;
@@ -62,20 +69,16 @@ void Camera::UpdateCameraVectors() {
 
     if (FollowTarget) {
         // 代表此相機的旋轉是依據他的 target 的，所以先求出半徑（球形座標相機）
-        glm::vec4 radius = glm::vec4(0.0f, 0.0f, Distance, 1.0f);
-
         // 這邊 FollowTarget 我只專門用給那三個正交攝影機，設計專門跟隨著第一人稱視角的攝影機，所以說這邊我就不考慮 roll 了
-        glm::mat4 rotateMatrix = glm::mat4(1.0f);
-        rotateMatrix = glm::rotate(rotateMatrix, glm::radians(-Yaw), glm::vec3(0.0f, 1.0f, 0.0f));
-        rotateMatrix = glm::rotate(rotateMatrix, glm::radians(Pitch), glm::vec3(1.0f, 0.0f, 0.0f));
-
-        // 攝影機會跟隨著目標移動
-        glm::mat4 translation = glm::translate(glm::mat4(1.0f), glm::vec3(Target.x, Target.y, Target.z));
+        // 位置為 translate(Target) * rotate(-Yaw, y) * rotate(Pitch, x) * (0, 0, Distance)，展開之後只剩下這幾個 sin / cos
+        float yaw = glm::radians(Yaw);
+        float pitch = glm::radians(Pitch);
+        glm::vec3 pos = Target + Distance * glm::vec3(-std::cos(pitch) * std::sin(yaw), -std::sin(pitch),
+            std::cos(pitch) * std::cos(yaw));
 
-        glm::vec4 pos = translation * rotateMatrix * radius;
-
-        // 求出位置
-        Position = glm::vec3(pos.x, pos.y, pos.z);
+        // 求出位置，跟隨 target 的相機沒有自己的速度，不需要內插
+        Position = pos;
+        RenderPosition = pos;
 
         // Gram-Schmidt Orthogonalization 正交化求攝影機三軸
         Front = glm::normalize(Target - Position);
@@ -86,17 +89,15 @@ void Camera::UpdateCameraVectors() {
         // 因為 rotation 是逆時針旋轉(角度為正時)，而因為攝影機朝向負 z 軸，滑鼠的相對座標（螢幕坐標系）往右是正（向左轉），往左是負（向右轉）
         // 所以 Yaw 必須轉為負值，或者是將旋轉軸反過來也可以，另外旋轉的順序也有關係，一般而言是 YXZ 的順序
         // 而萬向鎖就是只要 Pitch 旋轉是 ±90°，因為 Pitch 旋轉會影響到 Roll，所以此時 Yaw 以及 Roll 旋轉將會是一樣的效果（失去一個旋轉自由度）
-        glm::mat4 rotateMatrix = glm::mat4(1.0f);
-        rotateMatrix = glm::rotate(rotateMatrix, glm::radians(-Yaw), glm::vec3(0.0f, 1.0f, 0.0f));
-        rotateMatrix = glm::rotate(rotateMatrix, glm::radians(Pitch), glm::vec3(1.0f, 0.0f, 0.0f));
-        rotateMatrix = glm::rotate(rotateMatrix, glm::radians(Roll), glm::vec3(0.0f, 0.0f, -1.0f));
-
         // 記住攝影機的初始【前】向量永遠面向世界座標的 -z 軸。
-        front = rotateMatrix * front;
+        // 繞 -z 軸的 Roll 不會改變 (0, 0, -1)，所以 rotate(-Yaw, y) * rotate(Pitch, x) * rotate(Roll, -z) * front 展開後就是：
+        float yaw = glm::radians(Yaw);
+        float pitch = glm::radians(Pitch);
+        front = glm::vec4(std::cos(pitch) * std::sin(yaw), std::sin(pitch), -std::cos(pitch) * std::cos(yaw), 1.0f);
 
         // 將 front 當作旋轉軸，並且 Roll 為度數，去旋轉 WorldUp 即可。
-        WorldUp = glm::rotate(glm::mat4(1.0f), glm::radians(Roll), glm::vec3(front.x, front.y, front.z)) *
-            glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
+        WorldUp = matrix::Transform(matrix::Rotation(glm::radians(Roll), glm::vec3(front.x, front.y, front.z)),
+            glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
 
         // Gram-Schmidt Orthogonalization 正交化求攝影機三軸
         Front = glm::normalize(glm::vec3(front.x, front.y, front.z));
@@ -118,31 +119,10 @@ glm::mat4 Camera::View() {
     // 等價於 gluLookAt()
     // glm::mat4 view = glm::lookAt(Position, Position + Front, WorldUp);
 
-    // Calculate by yourself (Notice the zaxis faces to positive z)
-    glm::vec3 zaxis = glm::normalize(-Front);
-    glm::vec3 xaxis = glm::normalize(glm::cross(glm::normalize(WorldUp), zaxis));
-    glm::vec3 yaxis = glm::normalize(glm::cross(zaxis, xaxis));
-
-    // 記得 OpenGL 是 Column-Major
-    glm::mat4 translation = glm::mat4(1.0f);
-    translation[3][0] = -Position.x;
-    translation[3][1] = -Position.y;
-    translation[3][2] = -Position.z;
-
-    glm::mat4 rotation = glm::mat4(1.0f);
-    rotation[0][0] = xaxis.x;
-    rotation[1][0] = xaxis.y;
-    rotation[2][0] = xaxis.z;
-    rotation[0][1] = yaxis.x;
-    rotation[1][1] = yaxis.y;
-    rotation[2][1] = yaxis.z;
-    rotation[0][2] = zaxis.x;
-    rotation[1][2] = zaxis.y;
-    rotation[2][2] = zaxis.z;
-
-    glm::mat4 view = rotation * translation;
-
-    return view;
+    // 自己算的話是 rotation(xaxis, yaxis, zaxis) * translation(-Position)，其中 zaxis = -Front、
+    // xaxis = normalize(cross(WorldUp, zaxis))、yaxis = cross(zaxis, xaxis)，跟 lookAt 的定義完全相同，
+    // 所以直接交給 matrix::LookAt 一次算完（記得 OpenGL 是 Column-Major）
+    return matrix::LookAt(RenderPosition, RenderPosition + Front, WorldUp);
 }
 
 void Camera::ProcessKeyboard() {
@@ -251,18 +231,39 @@ void Camera::ToggleMouseControl() {
     MouseControl = !MouseControl;
 }
 
-void Camera::Update(float dt) {
+void Camera::Step(float dt) {
     UpdateCameraVectors();
+    PreviousPosition = Position;
 
     if (!FollowTarget) {
         Velocity += Acceleration * dt;
         Position += Velocity * dt;
 
+        // 原本是每個 frame 乘上 0.95，會隨著 frame rate 改變；改成以 60Hz 為準的每秒衰減率
         Acceleration = glm::vec3(0.0f);
-        Velocity *= 0.95f;
+        Velocity *= std::pow(0.95f, dt * 60.0f);
     }
 }
 
+void Camera::Interpolate(float alpha) {
+    UpdateCameraVectors();
+
+    if (!FollowTarget) {
+        RenderPosition = glm::mix(PreviousPosition, Position, alpha);
+    }
+
+    UpdateViewFrustum();
+}
+
+void Camera::Update(float dt) {
+    Step(dt);
+    Interpolate(1.0f);
+}
+
+void Camera::UpdateViewFrustum() {
+    ViewFrustum = Frustum::FromMatrix(matrix::Multiply(Projection(), View()));
+}
+
 glm::mat4 Camera::Projection() {
     UpdateProjectionParameters();
     if (IsPerspective) {
@@ -281,29 +282,14 @@ glm::mat4 Camera::Orthogonal() {
 }
 
 glm::mat4 Camera::Perspective() {
-    glm::mat4 proj = glm::mat4(1.0f);
-    // 等價於 glm::perspective()
-    proj = glm::perspective(glm::radians(Zoom), AspectRatio(), frustum.near, frustum.far);
-
-    proj[0][0] = 1 / (glm::tan(glm::radians(Zoom) / 2) * AspectRatio());
-    proj[1][0] = 0;
-    proj[2][0] = 0;
-    proj[3][0] = 0;
-
-    proj[0][1] = 0;
-    proj[1][1] = 1 / (glm::tan(glm::radians(Zoom) / 2));
-    proj[2][1] = 0;
-    proj[3][1] = 0;
-
-    proj[0][2] = 0;
-    proj[1][2] = 0;
+    // 等價於 glm::perspective()，直接填入非零的五個元素，不必先算一次 glm::perspective 再整個覆蓋掉
+    float tan_half_fovy = glm::tan(glm::radians(Zoom) / 2);
+    glm::mat4 proj = glm::mat4(0.0f);
+    proj[0][0] = 1 / (tan_half_fovy * AspectRatio());
+    proj[1][1] = 1 / tan_half_fovy;
     proj[2][2] = -(frustum.far + frustum.near) / (frustum.far - frustum.near);
     proj[3][2] = (-2 * frustum.far * frustum.near) / (frustum.far - frustum.near);
-
-    proj[0][3] = 0;
-    proj[1][3] = 0;
     proj[2][3] = -1;
-    proj[3][3] = 0;
 
     return proj;
 }
@@ -0,0 +1,213 @@
+#include "CompressedImage.hpp"
+#include "MappedFile.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    const unsigned char kIdentifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    constexpr std::uint32_t kEndianness = 0x04030201;
+
+    struct KtxHeader {
+        unsigned char identifier[12];
+        std::uint32_t endianness;
+        std::uint32_t gl_type;
+        std::uint32_t gl_type_size;
+        std::uint32_t gl_format;
+        std::uint32_t gl_internal_format;
+        std::uint32_t gl_base_internal_format;
+        std::uint32_t pixel_width;
+        std::uint32_t pixel_height;
+        std::uint32_t pixel_depth;
+        std::uint32_t number_of_array_elements;
+        std::uint32_t number_of_faces;
+        std::uint32_t number_of_mipmap_levels;
+        std::uint32_t bytes_of_key_value_data;
+    };
+    static_assert(sizeof(KtxHeader) == 64, "KTX header must be 64 bytes");
+
+    std::size_t Align4(std::size_t size) {
+        return (size + 3) & ~static_cast<std::size_t>(3);
+    }
+
+    // 與 mipmap::LevelCount 相同，但直接以檔頭的 uint32 計算，最多 32 層
+    std::uint32_t FullLevelCount(std::uint32_t width, std::uint32_t height) {
+        std::uint32_t size = std::max(width, height);
+        std::uint32_t levels = 1;
+        while (size > 1) {
+            size /= 2;
+            ++levels;
+        }
+        return levels;
+    }
+
+    std::uint32_t ReadU32(const unsigned char* p) {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void WriteU32(std::ofstream& file, std::uint32_t value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void WritePadding(std::ofstream& file, std::size_t size) {
+        static const char zeros[4] = {};
+        file.write(zeros, static_cast<std::streamsize>(Align4(size) - size));
+    }
+}
+
+namespace compressed_format {
+    std::size_t BlockBytes(std::uint32_t internal_format) {
+        switch (internal_format) {
+            case Bc1:
+            case Etc2Rgb:
+                return 8;
+            case Bc3:
+            case Bc7:
+            case Etc2Rgba:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
+    std::size_t LevelSize(std::uint32_t internal_format, int width, int height) {
+        return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(internal_format);
+    }
+}
+
+CompressedImage::CompressedImage(const std::string& filename) {
+    PROFILE_ZONE("Load compressed image");
+    auto mapping = std::make_shared<MappedFile>(filename);
+    if (!mapping->IsOpen() || mapping->Size() < sizeof(KtxHeader)) {
+        return;
+    }
+
+    KtxHeader header;
+    std::memcpy(&header, mapping->Data(), sizeof(header));
+    if (std::memcmp(header.identifier, kIdentifier, sizeof(kIdentifier)) != 0) {
+        std::cout << "Not a KTX file: " << filename << std::endl;
+        return;
+    }
+    // 只支援跟本機相同的位元組順序，也只支援壓縮過（gl_type 為 0）的 2D 貼圖
+    if (header.endianness != kEndianness || header.gl_type != 0 || header.pixel_depth > 1 ||
+        header.number_of_faces != 1 || compressed_format::BlockBytes(header.gl_internal_format) == 0) {
+        std::cout << "Unsupported KTX file: " << filename << std::endl;
+        return;
+    }
+    // 層數不能超過完整 mip chain 的長度，否則 pixel_width >> level 會位移超過 32 bits
+    if (header.number_of_mipmap_levels > FullLevelCount(header.pixel_width, header.pixel_height)) {
+        std::cout << "Invalid mipmap level count in KTX file: " << filename << std::endl;
+        return;
+    }
+
+    const unsigned char* data = mapping->Data();
+    const std::size_t size = mapping->Size();
+    std::size_t offset = sizeof(KtxHeader);
+    if (header.bytes_of_key_value_data > size - offset) {
+        std::cout << "Truncated KTX file: " << filename << std::endl;
+        return;
+    }
+
+    std::size_t key_value_end = offset + header.bytes_of_key_value_data;
+    std::map<std::string, std::string> entries;
+    while (offset + 4 <= key_value_end) {
+        std::uint32_t length = ReadU32(data + offset);
+        offset += 4;
+        if (length > key_value_end - offset) {
+            break;
+        }
+        // key 與 value 之間以 NUL 分隔，value 結尾的 NUL 不算在內
+        const char* text = reinterpret_cast<const char*>(data + offset);
+        std::size_t key_length = static_cast<std::size_t>(std::find(text, text + length, '\0') - text);
+        if (key_length < length) {
+            std::string value(text + key_length + 1, length - key_length - 1);
+            while (!value.empty() && value.back() == '\0') {
+                value.pop_back();
+            }
+            entries[std::string(text, key_length)] = value;
+        }
+        offset += Align4(length);
+    }
+    offset = key_value_end;
+
+    const int array_layers = static_cast<int>(header.number_of_array_elements);
+    const std::size_t layer_count = std::max(1, array_layers);
+    const std::uint32_t level_count = std::max<std::uint32_t>(1, header.number_of_mipmap_levels);
+    std::vector<Level> chain;
+    for (std::uint32_t level = 0; level < level_count; ++level) {
+        int level_width = std::max(1, static_cast<int>(header.pixel_width >> level));
+        int level_height = std::max(1, static_cast<int>(header.pixel_height >> level));
+        std::size_t expected = compressed_format::LevelSize(header.gl_internal_format, level_width, level_height) * layer_count;
+        if (size - offset < 4) {
+            std::cout << "Truncated KTX file: " << filename << std::endl;
+            return;
+        }
+        std::size_t image_size = ReadU32(data + offset);
+        offset += 4;
+        if (image_size != expected || image_size > size - offset) {
+            std::cout << "Truncated KTX file: " << filename << std::endl;
+            return;
+        }
+        chain.push_back({ level_width, level_height, image_size, std::shared_ptr<const unsigned char>(mapping, data + offset) });
+        offset += Align4(image_size);
+    }
+
+    internal_format = header.gl_internal_format;
+    base_format = header.gl_base_internal_format;
+    width = static_cast<int>(header.pixel_width);
+    height = static_cast<int>(header.pixel_height);
+    layers = array_layers;
+    levels = std::move(chain);
+    metadata = std::move(entries);
+}
+
+bool CompressedImage::IsValid() const {
+    return !levels.empty();
+}
+
+bool CompressedImage::Save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to write " << filename << std::endl;
+        return false;
+    }
+
+    std::size_t key_value_bytes = 0;
+    for (const auto& entry : metadata) {
+        key_value_bytes += 4 + Align4(entry.first.size() + 1 + entry.second.size() + 1);
+    }
+
+    KtxHeader header = {};
+    std::memcpy(header.identifier, kIdentifier, sizeof(kIdentifier));
+    header.endianness = kEndianness;
+    header.gl_type_size = 1;
+    header.gl_internal_format = internal_format;
+    header.gl_base_internal_format = base_format;
+    header.pixel_width = static_cast<std::uint32_t>(width);
+    header.pixel_height = static_cast<std::uint32_t>(height);
+    header.number_of_array_elements = static_cast<std::uint32_t>(layers);
+    header.number_of_faces = 1;
+    header.number_of_mipmap_levels = static_cast<std::uint32_t>(levels.size());
+    header.bytes_of_key_value_data = static_cast<std::uint32_t>(key_value_bytes);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& entry : metadata) {
+        std::size_t length = entry.first.size() + 1 + entry.second.size() + 1;
+        WriteU32(file, static_cast<std::uint32_t>(length));
+        file.write(entry.first.c_str(), static_cast<std::streamsize>(entry.first.size() + 1));
+        file.write(entry.second.c_str(), static_cast<std::streamsize>(entry.second.size() + 1));
+        WritePadding(file, length);
+    }
+
+    for (const Level& level : levels) {
+        WriteU32(file, static_cast<std::uint32_t>(level.size));
+        file.write(reinterpret_cast<const char*>(level.data.get()), static_cast<std::streamsize>(level.size));
+        WritePadding(file, level.size);
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,49 @@
+#include "FixedTimestep.hpp"
+
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(double tick_rate, int max_steps) :
+    m_step(1.0 / std::max(tick_rate, 1.0)), m_max_steps(std::max(max_steps, 1)), m_accumulator(0.0), m_ticks(0) {
+}
+
+int FixedTimestep::Advance(double frame_time) {
+    m_accumulator += std::max(frame_time, 0.0);
+
+    // 來不及模擬的時間直接丟掉，只保留最多 max_steps 個 tick
+    double limit = m_step * m_max_steps;
+    if (m_accumulator > limit) {
+        m_accumulator = limit;
+    }
+
+    // 留一點誤差，避免 frame time 剛好是 Step 的整數倍時因為浮點誤差少跑一個 tick
+    return static_cast<int>((m_accumulator + m_step * 1e-6) / m_step);
+}
+
+void FixedTimestep::Tick() {
+    m_accumulator = std::max(m_accumulator - m_step, 0.0);
+    ++m_ticks;
+}
+
+double FixedTimestep::Step() const {
+    return m_step;
+}
+
+double FixedTimestep::TickRate() const {
+    return 1.0 / m_step;
+}
+
+double FixedTimestep::Time() const {
+    return static_cast<double>(m_ticks) * m_step;
+}
+
+std::uint64_t FixedTimestep::Ticks() const {
+    return m_ticks;
+}
+
+float FixedTimestep::Alpha() const {
+    return static_cast<float>(std::min(m_accumulator / m_step, 1.0 - 1e-6));
+}
+
+double FixedTimestep::RenderTime() const {
+    return std::max(Time() - (1.0 - Alpha()) * m_step, 0.0);
+}
@@ -0,0 +1,148 @@
+#include "Frustum.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+#ifdef FRUSTUM_SSE
+    // _mm_movemask_ps 的 4-bit 結果中有幾個 1
+    constexpr std::uint8_t kMaskCount[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+    // 六個平面各自廣播成 (a, b, c, d, |a|, |b|, |c|)，整批測試只需要準備一次
+    struct PlaneLanes {
+        __m128 a[6], b[6], c[6], d[6];
+        __m128 abs_a[6], abs_b[6], abs_c[6];
+
+        explicit PlaneLanes(const Frustum& frustum) {
+            for (int p = 0; p < 6; ++p) {
+                const glm::vec4& plane = frustum.planes[p];
+                a[p] = _mm_set1_ps(plane.x);
+                b[p] = _mm_set1_ps(plane.y);
+                c[p] = _mm_set1_ps(plane.z);
+                d[p] = _mm_set1_ps(plane.w);
+                abs_a[p] = _mm_set1_ps(std::fabs(plane.x));
+                abs_b[p] = _mm_set1_ps(std::fabs(plane.y));
+                abs_c[p] = _mm_set1_ps(std::fabs(plane.z));
+            }
+        }
+    };
+
+    inline std::size_t StoreMask(int mask, std::uint8_t* visible) {
+        visible[0] = static_cast<std::uint8_t>(mask & 1);
+        visible[1] = static_cast<std::uint8_t>((mask >> 1) & 1);
+        visible[2] = static_cast<std::uint8_t>((mask >> 2) & 1);
+        visible[3] = static_cast<std::uint8_t>((mask >> 3) & 1);
+        return kMaskCount[mask];
+    }
+#endif
+}
+
+Frustum Frustum::FromMatrix(const glm::mat4& m) {
+    // clip = M * p，點在視錐內代表 -w <= x, y, z <= w，每個不等式就是一個平面：row3 ± row0..2
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; ++i) {
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+    }
+
+    Frustum frustum;
+    frustum.planes[Left] = row[3] + row[0];
+    frustum.planes[Right] = row[3] - row[0];
+    frustum.planes[Bottom] = row[3] + row[1];
+    frustum.planes[Top] = row[3] - row[1];
+    frustum.planes[Near] = row[3] + row[2];
+    frustum.planes[Far] = row[3] - row[2];
+
+    for (auto& plane : frustum.planes) {
+        plane *= 1.0f / glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const {
+    for (const auto& plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::IntersectsAabb(const glm::vec3& center, const glm::vec3& extent) const {
+    // 把 AABB 投影到平面法向量上的半徑為 |n| · extent
+    for (const auto& plane : planes) {
+        float radius = std::fabs(plane.x) * extent.x + std::fabs(plane.y) * extent.y + std::fabs(plane.z) * extent.z;
+        if (glm::dot(glm::vec3(plane), center) + plane.w + radius < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace culling {
+    std::size_t CullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+        std::size_t count, std::uint8_t* visible) {
+        std::size_t visible_count = 0;
+        std::size_t i = 0;
+#ifdef FRUSTUM_SSE
+        const PlaneLanes lanes(frustum);
+        for (; i + 4 <= count; i += 4) {
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 pz = _mm_loadu_ps(z + i);
+            __m128 neg_r = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+            // 四個包圍體同時對同一個平面測試，任何一個平面在外側就被剔除
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; ++p) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, lanes.a[p]), _mm_mul_ps(py, lanes.b[p])),
+                    _mm_add_ps(_mm_mul_ps(pz, lanes.c[p]), lanes.d[p]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, neg_r));
+            }
+            visible_count += StoreMask(_mm_movemask_ps(inside), visible + i);
+        }
+#endif
+        for (; i < count; ++i) {
+            visible[i] = frustum.IntersectsSphere(glm::vec3(x[i], y[i], z[i]), radius[i]) ? 1 : 0;
+            visible_count += visible[i];
+        }
+        return visible_count;
+    }
+
+    std::size_t CullAabbs(const Frustum& frustum, const float* x, const float* y, const float* z,
+        const float* extent_x, const float* extent_y, const float* extent_z, std::size_t count, std::uint8_t* visible) {
+        std::size_t visible_count = 0;
+        std::size_t i = 0;
+#ifdef FRUSTUM_SSE
+        const PlaneLanes lanes(frustum);
+        for (; i + 4 <= count; i += 4) {
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 pz = _mm_loadu_ps(z + i);
+            __m128 ex = _mm_loadu_ps(extent_x + i);
+            __m128 ey = _mm_loadu_ps(extent_y + i);
+            __m128 ez = _mm_loadu_ps(extent_z + i);
+
+            // 中心到平面的距離 + AABB 投影在法向量上的半徑 < 0 就完全在外側
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; ++p) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, lanes.a[p]), _mm_mul_ps(py, lanes.b[p])),
+                    _mm_add_ps(_mm_mul_ps(pz, lanes.c[p]), lanes.d[p]));
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, lanes.abs_a[p]), _mm_mul_ps(ey, lanes.abs_b[p])),
+                    _mm_mul_ps(ez, lanes.abs_c[p]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+            visible_count += StoreMask(_mm_movemask_ps(inside), visible + i);
+        }
+#endif
+        for (; i < count; ++i) {
+            visible[i] = frustum.IntersectsAabb(glm::vec3(x[i], y[i], z[i]), glm::vec3(extent_x[i], extent_y[i], extent_z[i]))
+                ? 1 : 0;
+            visible_count += visible[i];
+        }
+        return visible_count;
+    }
+}
@@ -0,0 +1,44 @@
+#include "GpuTimer.hpp"
+
+GpuTimer::GpuTimer() : m_pending{}, m_next(0) {
+    glGenQueries(static_cast<GLsizei>(Latency), m_queries);
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(static_cast<GLsizei>(Latency), m_queries);
+}
+
+void GpuTimer::Begin() {
+    // 這個 slot 上一次的結果還沒讀過，先讀出來才能重複使用
+    if (m_pending[m_next]) {
+        Collect(m_next);
+    }
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_next]);
+}
+
+void GpuTimer::End() {
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_next] = true;
+    m_next = (m_next + 1) % Latency;
+}
+
+void GpuTimer::Finish() {
+    // 從最舊的 slot 開始讀，維持 frame 的順序
+    for (std::size_t i = 0; i < Latency; ++i) {
+        std::size_t slot = (m_next + i) % Latency;
+        if (m_pending[slot]) {
+            Collect(slot);
+        }
+    }
+}
+
+const std::vector<float>& GpuTimer::Samples() const {
+    return m_samples;
+}
+
+void GpuTimer::Collect(std::size_t slot) {
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(m_queries[slot], GL_QUERY_RESULT, &elapsed);
+    m_samples.push_back(static_cast<float>(static_cast<double>(elapsed) / 1.0e6));
+    m_pending[slot] = false;
+}
@@ -0,0 +1,34 @@
+#include "Image.hpp"
+#include "Profiler.hpp"
+
+#include "stb_image.h"
+
+static std::shared_ptr<const unsigned char> TakeOwnership(stbi_uc* data) {
+    if (data == nullptr) {
+        return nullptr;
+    }
+    return std::shared_ptr<const unsigned char>(data, [](const unsigned char* p) {
+        stbi_image_free(const_cast<unsigned char*>(p));
+    });
+}
+
+Image::Image(const std::string& filename) {
+    PROFILE_ZONE("Decode image");
+    // 只翻轉這條執行緒所讀取的圖片，背景解碼的 worker 之間才不會互相干擾
+    stbi_set_flip_vertically_on_load_thread(true);
+    pixels = TakeOwnership(stbi_load(filename.c_str(), &width, &height, &channels, 0));
+}
+
+Image::Image(const unsigned char* buffer, std::size_t length) {
+    PROFILE_ZONE("Decode image");
+    stbi_set_flip_vertically_on_load_thread(true);
+    pixels = TakeOwnership(stbi_load_from_memory(buffer, static_cast<int>(length), &width, &height, &channels, 0));
+}
+
+bool Image::IsValid() const {
+    return pixels != nullptr;
+}
+
+std::size_t Image::Size() const {
+    return static_cast<std::size_t>(width) * height * channels;
+}
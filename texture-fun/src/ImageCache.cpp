@@ -0,0 +1,218 @@
+#include "ImageCache.hpp"
+
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+#include "Profiler.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char kMagic[4] = { 'T', 'E', 'X', 'C' };
+    constexpr std::uint64_t kDataAlignment = 64;
+
+    struct CacheHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t source_size;
+        std::int64_t source_mtime;
+        std::uint64_t source_hash;
+        std::int32_t width;
+        std::int32_t height;
+        std::int32_t channels;
+        std::int32_t mipmap_filter;
+        std::uint32_t levels;
+    };
+
+    struct CacheLevel {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    const CacheHeader* ReadHeader(const MappedFile& file) {
+        if (!file.IsOpen() || file.Size() < sizeof(CacheHeader)) {
+            return nullptr;
+        }
+
+        const CacheHeader* header = reinterpret_cast<const CacheHeader*>(file.Data());
+        if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != ImageCache::kVersion) {
+            return nullptr;
+        }
+        if (header->levels == 0 || file.Size() < sizeof(CacheHeader) + header->levels * sizeof(CacheLevel)) {
+            return nullptr;
+        }
+        return header;
+    }
+
+    Image MapImage(const std::shared_ptr<MappedFile>& file, const CacheHeader& header) {
+        const CacheLevel* levels = reinterpret_cast<const CacheLevel*>(file->Data() + sizeof(CacheHeader));
+
+        Image image;
+        image.width = header.width;
+        image.height = header.height;
+        image.channels = header.channels;
+
+        for (std::uint32_t i = 0; i < header.levels; ++i) {
+            const CacheLevel& level = levels[i];
+            std::uint64_t expected = static_cast<std::uint64_t>(level.width) * level.height * header.channels;
+            if (level.offset + level.size > file->Size() || level.size != expected) {
+                return Image();
+            }
+
+            // 與 mapping 共用擁有權，Image 還活著時檔案就不會被 unmap
+            std::shared_ptr<const unsigned char> pixels(file, file->Data() + level.offset);
+            if (i == 0) {
+                image.pixels = pixels;
+            } else {
+                image.mipmaps.push_back({ static_cast<int>(level.width), static_cast<int>(level.height), pixels });
+            }
+        }
+        return image;
+    }
+
+    std::uint64_t AlignUp(std::uint64_t value) {
+        return (value + kDataAlignment - 1) & ~(kDataAlignment - 1);
+    }
+}
+
+ImageCache::ImageCache(const std::string& directory) : m_directory(directory) {}
+
+ImageCache& ImageCache::Default() {
+    static ImageCache cache;
+    return cache;
+}
+
+Image ImageCache::Load(const std::string& filename, MipmapFilter filter) {
+    PROFILE_ZONE("Load image");
+    if (m_directory.empty()) {
+        Image image(filename);
+        mipmap::Generate(image, filter);
+        return image;
+    }
+
+    std::error_code error;
+    std::uint64_t source_size = fs::file_size(filename, error);
+    if (error) {
+        return Image();
+    }
+    std::int64_t source_mtime = fs::last_write_time(filename, error).time_since_epoch().count();
+
+    // 1. 大小與修改時間都相同，直接使用快取
+    std::string cache_path = CachePath(filename, filter);
+    auto mapping = std::make_shared<MappedFile>(cache_path);
+    const CacheHeader* header = ReadHeader(*mapping);
+    if (header && header->mipmap_filter != static_cast<std::int32_t>(filter)) {
+        header = nullptr;
+    }
+    if (header && header->source_size == source_size && header->source_mtime == source_mtime) {
+        Image image = MapImage(mapping, *header);
+        if (image.IsValid()) {
+            return image;
+        }
+    }
+
+    // 2. 修改時間變了，但內容雜湊沒變（例如重新 checkout），快取依然有效
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<unsigned char> source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::uint64_t source_hash = hash::Fnv1a(source.data(), source.size());
+    if (header && header->source_size == source_size && header->source_hash == source_hash) {
+        Image image = MapImage(mapping, *header);
+        if (image.IsValid()) {
+            // 更新檔頭的修改時間，下次就能直接命中而不用再讀取來源
+            Store(cache_path, image, filter, source_size, source_mtime, source_hash);
+            return image;
+        }
+    }
+
+    // 3. 快取不存在或已失效，重新解碼並寫入新的快取
+    mapping.reset();
+    Image image(source.data(), source.size());
+    mipmap::Generate(image, filter);
+    if (image.IsValid()) {
+        Store(cache_path, image, filter, source_size, source_mtime, source_hash);
+    }
+    return image;
+}
+
+std::string ImageCache::CachePath(const std::string& filename, MipmapFilter filter) const {
+    std::error_code error;
+    fs::path canonical = fs::weakly_canonical(filename, error);
+    std::uint64_t key = hash::Fnv1a(error ? filename : canonical.generic_string());
+    key = hash::Fnv1a(&filter, sizeof(filter), key);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.tex", static_cast<unsigned long long>(key));
+    return (fs::path(m_directory) / name).string();
+}
+
+void ImageCache::Store(const std::string& cache_path, const Image& image, MipmapFilter filter, std::uint64_t source_size,
+    std::int64_t source_mtime, std::uint64_t source_hash) const {
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+    if (error) {
+        std::cerr << "[Warning] Failed to create texture cache directory: " << m_directory << std::endl;
+        return;
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.source_size = source_size;
+    header.source_mtime = source_mtime;
+    header.source_hash = source_hash;
+    header.width = image.width;
+    header.height = image.height;
+    header.channels = image.channels;
+    header.mipmap_filter = static_cast<std::int32_t>(filter);
+    header.levels = static_cast<std::uint32_t>(image.mipmaps.size() + 1);
+
+    std::vector<CacheLevel> levels(header.levels);
+    std::vector<const unsigned char*> level_pixels(header.levels);
+    std::uint64_t offset = AlignUp(sizeof(CacheHeader) + header.levels * sizeof(CacheLevel));
+    for (std::uint32_t i = 0; i < header.levels; ++i) {
+        CacheLevel& level = levels[i];
+        level.width = static_cast<std::uint32_t>(i == 0 ? image.width : image.mipmaps[i - 1].width);
+        level.height = static_cast<std::uint32_t>(i == 0 ? image.height : image.mipmaps[i - 1].height);
+        level.offset = offset;
+        level.size = static_cast<std::uint64_t>(level.width) * level.height * image.channels;
+        level_pixels[i] = i == 0 ? image.pixels.get() : image.mipmaps[i - 1].pixels.get();
+        offset = AlignUp(offset + level.size);
+    }
+
+    // 先寫到暫存檔再改名，避免其他執行緒或行程讀到寫到一半的快取
+    std::string temp_path = cache_path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "[Warning] Failed to write texture cache: " << cache_path << std::endl;
+            return;
+        }
+
+        const char padding[kDataAlignment] = {};
+        std::uint64_t written = sizeof(CacheHeader) + levels.size() * sizeof(CacheLevel);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(levels.size() * sizeof(CacheLevel)));
+        for (std::uint32_t i = 0; i < header.levels; ++i) {
+            file.write(padding, static_cast<std::streamsize>(levels[i].offset - written));
+            file.write(reinterpret_cast<const char*>(level_pixels[i]), static_cast<std::streamsize>(levels[i].size));
+            written = levels[i].offset + levels[i].size;
+        }
+    }
+
+    fs::rename(temp_path, cache_path, error);
+    if (error) {
+        fs::remove(temp_path, error);
+    }
+}
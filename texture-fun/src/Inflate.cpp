@@ -0,0 +1,523 @@
+#include "Inflate.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    constexpr int kLitLenTableBits = 11;
+    constexpr int kDistTableBits = 10;
+    constexpr int kCodeLenTableBits = 7;
+    constexpr int kMaxCodeBits = 15;
+
+    // 一次迴圈最多寫出 258 bytes 的 match，再加上 8 bytes 寬複製可能多寫的部分
+    constexpr std::ptrdiff_t kOutputSlack = 258 + 8;
+
+    // 查表 entry 的格式（32-bit）：
+    //   bits 0..4   要消耗的 bits 數（literal pair 時為兩個 code 的長度總和）
+    //   bits 5..7   種類
+    //   bits 8..12  extra bits 數（length / distance）；literal 時 bit 8 代表是否有第二個 literal
+    //   bits 16..31 literal 值（一或兩個）或是 length / distance 的 base
+    enum EntryKind : std::uint32_t {
+        kLiteral = 0,
+        kLength = 1,
+        kEndOfBlock = 2,
+        kDistance = 3,
+        kSlow = 4,
+        kInvalid = 5,
+    };
+
+    constexpr std::uint32_t Entry(std::uint32_t bits, EntryKind kind, std::uint32_t extra, std::uint32_t value) {
+        return bits | (kind << 5) | (extra << 8) | (value << 16);
+    }
+    constexpr std::uint32_t EntryBits(std::uint32_t e) { return e & 31; }
+    constexpr std::uint32_t EntryKindOf(std::uint32_t e) { return (e >> 5) & 7; }
+    constexpr std::uint32_t EntryExtra(std::uint32_t e) { return (e >> 8) & 31; }
+    constexpr std::uint32_t EntryValue(std::uint32_t e) { return e >> 16; }
+
+    const std::uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67,
+        83, 99, 115, 131, 163, 195, 227, 258 };
+    const std::uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5,
+        5, 5, 0 };
+    const std::uint16_t kDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+        1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    const std::uint8_t kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11,
+        11, 12, 12, 13, 13 };
+
+    enum class Alphabet { LitLen, Dist, CodeLen };
+
+    std::uint32_t SymbolEntry(Alphabet alphabet, int symbol, int bits) {
+        switch (alphabet) {
+            case Alphabet::LitLen:
+                if (symbol < 256) {
+                    return Entry(bits, kLiteral, 0, static_cast<std::uint32_t>(symbol));
+                }
+                if (symbol == 256) {
+                    return Entry(bits, kEndOfBlock, 0, 0);
+                }
+                if (symbol <= 285) {
+                    return Entry(bits, kLength, kLengthExtra[symbol - 257], kLengthBase[symbol - 257]);
+                }
+                return Entry(bits, kInvalid, 0, 0);
+            case Alphabet::Dist:
+                if (symbol < 30) {
+                    return Entry(bits, kDistance, kDistExtra[symbol], kDistBase[symbol]);
+                }
+                return Entry(bits, kInvalid, 0, 0);
+            case Alphabet::CodeLen:
+            default:
+                return Entry(bits, kLiteral, 0, static_cast<std::uint32_t>(symbol));
+        }
+    }
+
+    int ReverseBits(int code, int bits) {
+        int reversed = 0;
+        for (int i = 0; i < bits; ++i) {
+            reversed = (reversed << 1) | (code & 1);
+            code >>= 1;
+        }
+        return reversed;
+    }
+
+    struct Huffman {
+        Alphabet alphabet;
+        int table_bits;
+        std::uint32_t table[1 << kLitLenTableBits];
+
+        // 超過 table_bits 的長 code 很少見，以 canonical 的方式逐 bit 解碼
+        std::uint16_t count[kMaxCodeBits + 1];
+        std::uint16_t symbols[288];
+
+        bool Build(const std::uint8_t* lengths, int num, Alphabet alpha, int bits) {
+            alphabet = alpha;
+            table_bits = bits;
+            std::memset(count, 0, sizeof(count));
+            for (int i = 0; i < num; ++i) {
+                ++count[lengths[i]];
+            }
+            count[0] = 0;
+
+            // 不允許 over-subscribed 的 code，但與 zlib 相同允許不完整的 code
+            int left = 1;
+            std::uint16_t offsets[kMaxCodeBits + 2];
+            offsets[1] = 0;
+            for (int len = 1; len <= kMaxCodeBits; ++len) {
+                left = (left << 1) - count[len];
+                if (left < 0) {
+                    return false;
+                }
+                offsets[len + 1] = static_cast<std::uint16_t>(offsets[len] + count[len]);
+            }
+            for (int i = 0; i < num; ++i) {
+                if (lengths[i]) {
+                    symbols[offsets[lengths[i]]++] = static_cast<std::uint16_t>(i);
+                }
+            }
+
+            const int size = 1 << table_bits;
+            for (int i = 0; i < size; ++i) {
+                table[i] = Entry(0, kInvalid, 0, 0);
+            }
+
+            int code = 0;
+            int index = 0;
+            for (int len = 1; len <= kMaxCodeBits; ++len) {
+                for (int k = 0; k < count[len]; ++k, ++index, ++code) {
+                    int symbol = symbols[index];
+                    if (len <= table_bits) {
+                        std::uint32_t entry = SymbolEntry(alphabet, symbol, len);
+                        for (int j = ReverseBits(code, len); j < size; j += 1 << len) {
+                            table[j] = entry;
+                        }
+                    } else {
+                        // 前 table_bits 個 bits 相同的長 code 共用一個 slow entry
+                        int prefix = ReverseBits(code >> (len - table_bits), table_bits);
+                        table[prefix] = Entry(0, kSlow, 0, 0);
+                    }
+                }
+                code <<= 1;
+            }
+            return true;
+        }
+
+        // 將兩個連續的短 literal 合併成同一個 entry
+        void PairLiterals() {
+            const int size = 1 << table_bits;
+            static thread_local std::uint32_t single[1 << kLitLenTableBits];
+            std::memcpy(single, table, sizeof(std::uint32_t) * size);
+
+            for (int i = 0; i < size; ++i) {
+                std::uint32_t first = single[i];
+                if (EntryKindOf(first) != kLiteral) {
+                    continue;
+                }
+                std::uint32_t first_bits = EntryBits(first);
+                std::uint32_t second = single[i >> first_bits];
+                std::uint32_t second_bits = EntryBits(second);
+                if (EntryKindOf(second) != kLiteral || first_bits + second_bits > static_cast<std::uint32_t>(table_bits)) {
+                    continue;
+                }
+                table[i] = (first_bits + second_bits) | (kLiteral << 5) | (1u << 8) | (EntryValue(first) << 16) |
+                    (EntryValue(second) << 24);
+            }
+        }
+
+        // 回傳與查表相同格式的 entry（bits 欄位為 code 長度）
+        std::uint32_t DecodeSlow(std::uint64_t bitbuf) const {
+            int code = 0;
+            int first = 0;
+            int index = 0;
+            for (int len = 1; len <= kMaxCodeBits; ++len) {
+                code |= static_cast<int>((bitbuf >> (len - 1)) & 1);
+                int n = count[len];
+                if (code - first < n) {
+                    return SymbolEntry(alphabet, symbols[index + code - first], len);
+                }
+                index += n;
+                first = (first + n) << 1;
+                code <<= 1;
+            }
+            return Entry(0, kInvalid, 0, 0);
+        }
+    };
+
+    struct Inflater {
+        const std::uint8_t* in;
+        const std::uint8_t* in_end;
+        std::uint64_t bitbuf;
+        std::uint32_t bitcount;
+        std::uint32_t overrun;
+
+        std::uint8_t* out_begin;
+        std::uint8_t* out;
+        std::uint8_t* out_end;
+
+        Huffman litlen;
+        Huffman dist;
+
+        void Refill() {
+            if (in_end - in >= 8) {
+                // 一次讀 8 bytes，只前進實際用到的 bytes 數（移位組合出 little-endian，compiler 會合併成單一 load）
+                std::uint64_t word = 0;
+                for (int i = 0; i < 8; ++i) {
+                    word |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+                }
+                bitbuf |= word << bitcount;
+                in += (63 - bitcount) >> 3;
+                bitcount |= 56;
+                return;
+            }
+            // 輸入快結束時逐 byte 讀取，超過結尾的部分補 0 並記錄下來
+            while (bitcount <= 56) {
+                if (in < in_end) {
+                    bitbuf |= static_cast<std::uint64_t>(*in++) << bitcount;
+                } else {
+                    ++overrun;
+                }
+                bitcount += 8;
+            }
+        }
+
+        std::uint32_t Bits(std::uint32_t n) const {
+            return static_cast<std::uint32_t>(bitbuf & ((std::uint64_t(1) << n) - 1));
+        }
+
+        void Consume(std::uint32_t n) {
+            bitbuf >>= n;
+            bitcount -= n;
+        }
+
+        std::uint32_t Receive(std::uint32_t n) {
+            if (bitcount < n) {
+                Refill();
+            }
+            std::uint32_t value = Bits(n);
+            Consume(n);
+            return value;
+        }
+
+        // 補 0 的 bytes 只能存在於 bit buffer 尚未消耗的部分，否則代表讀超過了輸入結尾
+        bool Overran() const {
+            return overrun > (bitcount >> 3);
+        }
+
+        bool Grow(std::ptrdiff_t needed) {
+            std::size_t used = static_cast<std::size_t>(out - out_begin);
+            std::size_t capacity = static_cast<std::size_t>(out_end - out_begin);
+            while (static_cast<std::ptrdiff_t>(capacity - used) < needed) {
+                capacity *= 2;
+            }
+            std::uint8_t* grown = static_cast<std::uint8_t*>(std::realloc(out_begin, capacity));
+            if (grown == nullptr) {
+                return false;
+            }
+            out_begin = grown;
+            out = grown + used;
+            out_end = grown + capacity;
+            return true;
+        }
+
+        bool StoredBlock() {
+            // 丟掉不足一個 byte 的部分，再把 bit buffer 中預讀的 bytes 還回輸入
+            Consume(bitcount & 7);
+            std::uint32_t buffered = bitcount >> 3;
+            if (overrun > buffered) {
+                return false;
+            }
+            in -= buffered - overrun;
+            bitbuf = 0;
+            bitcount = 0;
+            overrun = 0;
+
+            if (in_end - in < 4) {
+                return false;
+            }
+            std::uint32_t len = in[0] | (in[1] << 8);
+            std::uint32_t nlen = in[2] | (in[3] << 8);
+            in += 4;
+            if (nlen != (~len & 0xffff) || static_cast<std::uint32_t>(in_end - in) < len) {
+                return false;
+            }
+            if (out_end - out < static_cast<std::ptrdiff_t>(len) + kOutputSlack && !Grow(len + kOutputSlack)) {
+                return false;
+            }
+            std::memcpy(out, in, len);
+            in += len;
+            out += len;
+            return true;
+        }
+
+        bool FixedCodes() {
+            std::uint8_t lengths[288 + 32];
+            std::memset(lengths, 8, 144);
+            std::memset(lengths + 144, 9, 112);
+            std::memset(lengths + 256, 7, 24);
+            std::memset(lengths + 280, 8, 8);
+            std::memset(lengths + 288, 5, 32);
+            if (!litlen.Build(lengths, 288, Alphabet::LitLen, kLitLenTableBits) ||
+                !dist.Build(lengths + 288, 32, Alphabet::Dist, kDistTableBits)) {
+                return false;
+            }
+            litlen.PairLiterals();
+            return true;
+        }
+
+        bool DynamicCodes() {
+            static const std::uint8_t kOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+            std::uint32_t hlit = Receive(5) + 257;
+            std::uint32_t hdist = Receive(5) + 1;
+            std::uint32_t hclen = Receive(4) + 4;
+            if (hlit > 286 || hdist > 30) {
+                return false;
+            }
+
+            std::uint8_t codelen_lengths[19] = {};
+            for (std::uint32_t i = 0; i < hclen; ++i) {
+                codelen_lengths[kOrder[i]] = static_cast<std::uint8_t>(Receive(3));
+            }
+
+            Huffman codelen;
+            if (!codelen.Build(codelen_lengths, 19, Alphabet::CodeLen, kCodeLenTableBits)) {
+                return false;
+            }
+
+            std::uint8_t lengths[286 + 30];
+            std::uint32_t total = hlit + hdist;
+            std::uint32_t n = 0;
+            while (n < total) {
+                Refill();
+                std::uint32_t entry = codelen.table[Bits(kCodeLenTableBits)];
+                if (EntryKindOf(entry) != kLiteral) {
+                    return false;
+                }
+                Consume(EntryBits(entry));
+
+                std::uint32_t symbol = EntryValue(entry);
+                if (symbol < 16) {
+                    lengths[n++] = static_cast<std::uint8_t>(symbol);
+                    continue;
+                }
+
+                std::uint8_t fill = 0;
+                std::uint32_t repeat;
+                if (symbol == 16) {
+                    if (n == 0) {
+                        return false;
+                    }
+                    fill = lengths[n - 1];
+                    repeat = Receive(2) + 3;
+                } else if (symbol == 17) {
+                    repeat = Receive(3) + 3;
+                } else {
+                    repeat = Receive(7) + 11;
+                }
+                if (total - n < repeat) {
+                    return false;
+                }
+                std::memset(lengths + n, fill, repeat);
+                n += repeat;
+            }
+
+            if (!litlen.Build(lengths, static_cast<int>(hlit), Alphabet::LitLen, kLitLenTableBits) ||
+                !dist.Build(lengths + hlit, static_cast<int>(hdist), Alphabet::Dist, kDistTableBits)) {
+                return false;
+            }
+            litlen.PairLiterals();
+            return !Overran();
+        }
+
+        bool HuffmanBlock() {
+            const std::uint32_t litlen_mask = (1u << kLitLenTableBits) - 1;
+            const std::uint32_t dist_mask = (1u << kDistTableBits) - 1;
+
+            for (;;) {
+                if (out_end - out < kOutputSlack && !Grow(kOutputSlack)) {
+                    return false;
+                }
+
+                // 每圈最多消耗 15 + 5（length）+ 15 + 13（distance）= 48 bits，refill 後至少有 56 bits
+                // 截斷的輸入會一直讀到補上的 0，必須在這裡中止，避免無限制地輸出
+                Refill();
+                if (overrun && Overran()) {
+                    return false;
+                }
+                std::uint32_t entry = litlen.table[bitbuf & litlen_mask];
+                if (EntryKindOf(entry) == kSlow) {
+                    entry = litlen.DecodeSlow(bitbuf);
+                }
+                Consume(EntryBits(entry));
+
+                switch (EntryKindOf(entry)) {
+                    case kLiteral:
+                        // 不論是一個還是兩個 literal 都寫兩個 bytes，多寫的那個會在下一圈被覆蓋
+                        out[0] = static_cast<std::uint8_t>(entry >> 16);
+                        out[1] = static_cast<std::uint8_t>(entry >> 24);
+                        out += 1 + ((entry >> 8) & 1);
+                        continue;
+                    case kEndOfBlock:
+                        return !Overran();
+                    case kLength:
+                        break;
+                    default:
+                        return false;
+                }
+
+                std::uint32_t length = EntryValue(entry) + Bits(EntryExtra(entry));
+                Consume(EntryExtra(entry));
+
+                entry = dist.table[bitbuf & dist_mask];
+                if (EntryKindOf(entry) == kSlow) {
+                    entry = dist.DecodeSlow(bitbuf);
+                }
+                if (EntryKindOf(entry) != kDistance) {
+                    return false;
+                }
+                Consume(EntryBits(entry));
+                std::uint32_t distance = EntryValue(entry) + Bits(EntryExtra(entry));
+                Consume(EntryExtra(entry));
+
+                if (static_cast<std::uint32_t>(out - out_begin) < distance) {
+                    return false;
+                }
+
+                const std::uint8_t* src = out - distance;
+                std::uint8_t* end = out + length;
+                if (distance >= 8) {
+                    // 來源至少落後 8 bytes，所以每次 8 bytes 的複製都不會讀到還沒寫入的資料
+                    do {
+                        std::memcpy(out, src, 8);
+                        out += 8;
+                        src += 8;
+                    } while (out < end);
+                } else if (distance == 1) {
+                    std::memset(out, *src, length);
+                } else {
+                    while (out < end) {
+                        *out++ = *src++;
+                    }
+                }
+                out = end;
+            }
+        }
+
+        bool Run(bool parse_header) {
+            if (parse_header) {
+                if (in_end - in < 2) {
+                    return false;
+                }
+                std::uint32_t cmf = in[0];
+                std::uint32_t flg = in[1];
+                in += 2;
+                // compression method 8、沒有 preset dictionary、header checksum 正確
+                if ((cmf * 256 + flg) % 31 != 0 || (flg & 32) || (cmf & 15) != 8) {
+                    return false;
+                }
+            }
+
+            std::uint32_t final_block;
+            do {
+                final_block = Receive(1);
+                std::uint32_t type = Receive(2);
+                bool ok = false;
+                switch (type) {
+                    case 0:
+                        ok = StoredBlock();
+                        break;
+                    case 1:
+                        ok = FixedCodes() && HuffmanBlock();
+                        break;
+                    case 2:
+                        ok = DynamicCodes() && HuffmanBlock();
+                        break;
+                    default:
+                        break;
+                }
+                if (!ok) {
+                    return false;
+                }
+            } while (!final_block);
+            return true;
+        }
+    };
+}
+
+namespace fast_inflate {
+    char* DecodeZlibMalloc(const char* buffer, int len, int initial_size, int* outlen, int parse_header) {
+        if (buffer == nullptr || len < 0) {
+            return nullptr;
+        }
+
+        // Huffman 表約 20 KB，放在 heap 上避免佔用太多 worker thread 的 stack
+        Inflater* inflater = static_cast<Inflater*>(std::malloc(sizeof(Inflater)));
+        if (inflater == nullptr) {
+            return nullptr;
+        }
+
+        std::size_t capacity = static_cast<std::size_t>(initial_size > 0 ? initial_size : 1024) + kOutputSlack;
+        inflater->in = reinterpret_cast<const std::uint8_t*>(buffer);
+        inflater->in_end = inflater->in + len;
+        inflater->bitbuf = 0;
+        inflater->bitcount = 0;
+        inflater->overrun = 0;
+        inflater->out_begin = static_cast<std::uint8_t*>(std::malloc(capacity));
+        inflater->out = inflater->out_begin;
+        inflater->out_end = inflater->out_begin + capacity;
+
+        char* result = nullptr;
+        if (inflater->out_begin != nullptr) {
+            if (inflater->Run(parse_header != 0)) {
+                result = reinterpret_cast<char*>(inflater->out_begin);
+                if (outlen) {
+                    *outlen = static_cast<int>(inflater->out - inflater->out_begin);
+                }
+            } else {
+                std::free(inflater->out_begin);
+            }
+        }
+
+        std::free(inflater);
+        return result;
+    }
+}
@@ -0,0 +1,240 @@
+#include "MatrixMath.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATRIX_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // 繞 axis 旋轉的 3x3 矩陣（column-major，r[column][row]），Rodrigues 旋轉公式，與 glm::rotate 的展開方式相同
+    inline void RotationCoefficients(float radians, const glm::vec3& axis, float r[3][3]) {
+        const float c = std::cos(radians);
+        const float s = std::sin(radians);
+        const glm::vec3 n = glm::normalize(axis);
+        const glm::vec3 t = n * (1.0f - c);
+
+        r[0][0] = c + t.x * n.x;
+        r[0][1] = t.x * n.y + s * n.z;
+        r[0][2] = t.x * n.z - s * n.y;
+        r[1][0] = t.y * n.x - s * n.z;
+        r[1][1] = c + t.y * n.y;
+        r[1][2] = t.y * n.z + s * n.x;
+        r[2][0] = t.z * n.x + s * n.y;
+        r[2][1] = t.z * n.y - s * n.x;
+        r[2][2] = c + t.z * n.z;
+    }
+
+#ifdef MATRIX_MATH_SSE
+    // glm::mat4 是 column-major、四個 column 連續存放，但沒有保證 16-byte 對齊，所以一律使用 unaligned load/store
+    inline __m128 LoadColumn(const glm::mat4& m, int column) {
+        return _mm_loadu_ps(&m[column][0]);
+    }
+
+    inline void StoreColumn(glm::mat4& m, int column, __m128 value) {
+        _mm_storeu_ps(&m[column][0], value);
+    }
+
+    inline __m128 Load3(const glm::vec3& v, float w) {
+        return _mm_set_ps(w, v.z, v.y, v.x);
+    }
+
+    // a0 * x + a1 * y + a2 * z + a3 * w，也就是矩陣乘上一個 column
+    inline __m128 Combine(__m128 a0, __m128 a1, __m128 a2, __m128 a3, __m128 v) {
+        __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, x), _mm_mul_ps(a1, y)),
+            _mm_add_ps(_mm_mul_ps(a2, z), _mm_mul_ps(a3, w)));
+    }
+
+    // (a.yzx * b.zxy - a.zxy * b.yzx)，w 分量為 0
+    inline __m128 Cross(__m128 a, __m128 b) {
+        __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    // 前三個分量的內積，結果廣播到四個 lane
+    inline __m128 Dot3(__m128 a, __m128 b) {
+        __m128 p = _mm_mul_ps(a, b);
+        __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+        return _mm_add_ps(_mm_add_ps(x, y), z);
+    }
+
+    inline __m128 Normalize3(__m128 v) {
+        return _mm_div_ps(v, _mm_sqrt_ps(Dot3(v, v)));
+    }
+#endif
+}
+
+namespace matrix {
+    void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+#ifdef MATRIX_MATH_SSE
+        __m128 a0 = LoadColumn(a, 0), a1 = LoadColumn(a, 1), a2 = LoadColumn(a, 2), a3 = LoadColumn(a, 3);
+        __m128 b0 = LoadColumn(b, 0), b1 = LoadColumn(b, 1), b2 = LoadColumn(b, 2), b3 = LoadColumn(b, 3);
+        StoreColumn(out, 0, Combine(a0, a1, a2, a3, b0));
+        StoreColumn(out, 1, Combine(a0, a1, a2, a3, b1));
+        StoreColumn(out, 2, Combine(a0, a1, a2, a3, b2));
+        StoreColumn(out, 3, Combine(a0, a1, a2, a3, b3));
+#else
+        out = a * b;
+#endif
+    }
+
+    glm::mat4 Multiply(const glm::mat4& a, const glm::mat4& b) {
+        glm::mat4 out;
+        Multiply(a, b, out);
+        return out;
+    }
+
+    void MultiplyBatch(const glm::mat4& parent, const glm::mat4* locals, glm::mat4* out, std::size_t count) {
+#ifdef MATRIX_MATH_SSE
+        __m128 a0 = LoadColumn(parent, 0), a1 = LoadColumn(parent, 1);
+        __m128 a2 = LoadColumn(parent, 2), a3 = LoadColumn(parent, 3);
+        for (std::size_t i = 0; i < count; ++i) {
+            __m128 b0 = LoadColumn(locals[i], 0), b1 = LoadColumn(locals[i], 1);
+            __m128 b2 = LoadColumn(locals[i], 2), b3 = LoadColumn(locals[i], 3);
+            StoreColumn(out[i], 0, Combine(a0, a1, a2, a3, b0));
+            StoreColumn(out[i], 1, Combine(a0, a1, a2, a3, b1));
+            StoreColumn(out[i], 2, Combine(a0, a1, a2, a3, b2));
+            StoreColumn(out[i], 3, Combine(a0, a1, a2, a3, b3));
+        }
+#else
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = parent * locals[i];
+        }
+#endif
+    }
+
+    glm::vec4 Transform(const glm::mat4& m, const glm::vec4& v) {
+#ifdef MATRIX_MATH_SSE
+        glm::vec4 out;
+        __m128 r = Combine(LoadColumn(m, 0), LoadColumn(m, 1), LoadColumn(m, 2), LoadColumn(m, 3),
+            _mm_set_ps(v.w, v.z, v.y, v.x));
+        _mm_storeu_ps(&out[0], r);
+        return out;
+#else
+        return m * v;
+#endif
+    }
+
+    glm::mat4 AffineInverse(const glm::mat4& m) {
+#ifdef MATRIX_MATH_SSE
+        // 左上 3x3 的反矩陣的三個 row 分別為 (c1 x c2, c2 x c0, c0 x c1) / det
+        const __m128 w_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+        __m128 c0 = _mm_and_ps(LoadColumn(m, 0), w_mask);
+        __m128 c1 = _mm_and_ps(LoadColumn(m, 1), w_mask);
+        __m128 c2 = _mm_and_ps(LoadColumn(m, 2), w_mask);
+        __m128 t = LoadColumn(m, 3);
+
+        __m128 r0 = Cross(c1, c2);
+        __m128 r1 = Cross(c2, c0);
+        __m128 r2 = Cross(c0, c1);
+        __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), Dot3(c0, r0));
+        r0 = _mm_mul_ps(r0, inv_det);
+        r1 = _mm_mul_ps(r1, inv_det);
+        r2 = _mm_mul_ps(r2, inv_det);
+        __m128 r3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        // 新的平移量為 -(A^-1 * t)，轉置後三個 column 的 w 都是 0，所以 w 會剛好是 1
+        __m128 translation = Combine(r0, r1, r2, _mm_setzero_ps(), t);
+        translation = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), translation);
+
+        glm::mat4 out;
+        StoreColumn(out, 0, r0);
+        StoreColumn(out, 1, r1);
+        StoreColumn(out, 2, r2);
+        StoreColumn(out, 3, translation);
+        return out;
+#else
+        glm::mat3 inv = glm::inverse(glm::mat3(m));
+        glm::mat4 out = glm::mat4(inv);
+        out[3] = glm::vec4(-(inv * glm::vec3(m[3])), 1.0f);
+        return out;
+#endif
+    }
+
+    void Translate(glm::mat4& m, const glm::vec3& offset) {
+#ifdef MATRIX_MATH_SSE
+        StoreColumn(m, 3, Combine(LoadColumn(m, 0), LoadColumn(m, 1), LoadColumn(m, 2), LoadColumn(m, 3),
+            Load3(offset, 1.0f)));
+#else
+        m[3] = m[0] * offset.x + m[1] * offset.y + m[2] * offset.z + m[3];
+#endif
+    }
+
+    void Rotate(glm::mat4& m, float radians, const glm::vec3& axis) {
+        // m * R 只會動到前三個 column，而且每個 column 都是 m 前三個 column 的線性組合
+        float r[3][3];
+        RotationCoefficients(radians, axis, r);
+#ifdef MATRIX_MATH_SSE
+        __m128 m0 = LoadColumn(m, 0), m1 = LoadColumn(m, 1), m2 = LoadColumn(m, 2);
+        for (int i = 0; i < 3; ++i) {
+            StoreColumn(m, i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, _mm_set1_ps(r[i][0])),
+                _mm_mul_ps(m1, _mm_set1_ps(r[i][1]))), _mm_mul_ps(m2, _mm_set1_ps(r[i][2]))));
+        }
+#else
+        glm::vec4 m0 = m[0], m1 = m[1], m2 = m[2];
+        for (int i = 0; i < 3; ++i) {
+            m[i] = m0 * r[i][0] + m1 * r[i][1] + m2 * r[i][2];
+        }
+#endif
+    }
+
+    void Scale(glm::mat4& m, const glm::vec3& factor) {
+#ifdef MATRIX_MATH_SSE
+        StoreColumn(m, 0, _mm_mul_ps(LoadColumn(m, 0), _mm_set1_ps(factor.x)));
+        StoreColumn(m, 1, _mm_mul_ps(LoadColumn(m, 1), _mm_set1_ps(factor.y)));
+        StoreColumn(m, 2, _mm_mul_ps(LoadColumn(m, 2), _mm_set1_ps(factor.z)));
+#else
+        m[0] *= factor.x;
+        m[1] *= factor.y;
+        m[2] *= factor.z;
+#endif
+    }
+
+    glm::mat4 Rotation(float radians, const glm::vec3& axis) {
+        float r[3][3];
+        RotationCoefficients(radians, axis, r);
+        glm::mat4 out(1.0f);
+        for (int i = 0; i < 3; ++i) {
+            out[i] = glm::vec4(r[i][0], r[i][1], r[i][2], 0.0f);
+        }
+        return out;
+    }
+
+    glm::mat4 LookAt(const glm::vec3& eye, const glm::vec3& center, const glm::vec3& up) {
+#ifdef MATRIX_MATH_SSE
+        __m128 e = Load3(eye, 0.0f);
+        __m128 f = Normalize3(_mm_sub_ps(Load3(center, 0.0f), e));
+        __m128 s = Normalize3(Cross(f, Load3(up, 0.0f)));
+        __m128 u = Cross(s, f);
+        __m128 back = _mm_sub_ps(_mm_setzero_ps(), f);
+
+        // s, u, -f 是 view matrix 的前三個 row，轉置之後就是 column
+        __m128 c0 = s, c1 = u, c2 = back, c3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        __m128 translation = Combine(c0, c1, c2, _mm_setzero_ps(), e);
+        translation = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), translation);
+
+        glm::mat4 out;
+        StoreColumn(out, 0, c0);
+        StoreColumn(out, 1, c1);
+        StoreColumn(out, 2, c2);
+        StoreColumn(out, 3, translation);
+        return out;
+#else
+        return glm::lookAt(eye, center, up);
+#endif
+    }
+}
@@ -1,34 +1,62 @@
 #include "MatrixStack.hpp"
+#include "MatrixMath.hpp"
 
+#include <cstdlib>
 #include <iostream>
 
-MatrixStack::MatrixStack() {
-    stack.push(glm::mat4(1.0f));
+MatrixStack::MatrixStack() : m_size(1) {
+    m_stack[0] = glm::mat4(1.0f);
 }
 
 void MatrixStack::Push() {
-    stack.push(stack.top());
+    // 超過容量代表 Push / Pop 沒有成對，繼續畫下去只會得到錯的矩陣
+    if (m_size == Capacity) {
+        std::cerr << "The matrix stack is full!!! (capacity " << Capacity << ")" << std::endl;
+        exit(-42069);
+    }
+    m_stack[m_size] = m_stack[m_size - 1];
+    ++m_size;
 }
 
 void MatrixStack::Pop() {
-    if (IsEmpty()) {
-        std::cerr << "The matrix stack is empty!!!" << std::endl;
-        return;
+    // 最底層的單位矩陣不能被 Pop，否則之後的 Top / Save 都會讀寫 m_stack[-1]
+    if (m_size <= 1) {
+        std::cerr << "The matrix stack is empty!!! (cannot pop the root matrix)" << std::endl;
+        exit(-42069);
     }
-    stack.pop();
+    --m_size;
 }
 
 void MatrixStack::Save(const glm::mat4& matrix) {
-    // 記得要先 Pop，這個進來的 matrix 必須搭配 glm 的 gtc 版本。
-    // 會先把原本的 Top 的矩陣拿出來乘之後，再透過 Save 丟回堆疊。
-    stack.pop();
-    stack.push(matrix);
+    // 直接覆蓋 Top，不再需要先 Pop 再 Push
+    m_stack[m_size - 1] = matrix;
 }
 
 bool MatrixStack::IsEmpty() const {
-    return stack.empty();
+    return m_size == 0;
+}
+
+std::size_t MatrixStack::Size() const {
+    return m_size;
+}
+
+const glm::mat4& MatrixStack::Top() const {
+    return m_stack[m_size - 1];
+}
+
+void MatrixStack::Translate(const glm::vec3& offset) {
+    matrix::Translate(m_stack[m_size - 1], offset);
+}
+
+void MatrixStack::Rotate(float radians, const glm::vec3& axis) {
+    matrix::Rotate(m_stack[m_size - 1], radians, axis);
+}
+
+void MatrixStack::Scale(const glm::vec3& factor) {
+    matrix::Scale(m_stack[m_size - 1], factor);
 }
 
-glm::mat4 MatrixStack::Top() const {
-    return stack.top();
+void MatrixStack::Multiply(const glm::mat4& matrix) {
+    glm::mat4& top = m_stack[m_size - 1];
+    matrix::Multiply(top, matrix, top);
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "Mipmap.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIPMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr int kLinearToSrgbSize = 1 << 14;
+
+    // sRGB <-> 線性空間的轉換表，第一次使用時建立（function-local static 的初始化是 thread-safe 的）
+    struct SrgbTables {
+        float to_linear[256];
+        std::uint8_t to_srgb[kLinearToSrgbSize];
+
+        SrgbTables() {
+            for (int i = 0; i < 256; ++i) {
+                float c = i / 255.0f;
+                to_linear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < kLinearToSrgbSize; ++i) {
+                float l = i / static_cast<float>(kLinearToSrgbSize - 1);
+                float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                to_srgb[i] = static_cast<std::uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+        }
+    };
+
+    const SrgbTables& GetSrgbTables() {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    // 一般的 box filter：從 x 開始處理到這一列結束，row1 在高度為 1 時會等於 row0
+    void BoxRowScalar(const unsigned char* row0, const unsigned char* row1, int src_width, int channels,
+        unsigned char* dst, int x, int dst_width) {
+        for (; x < dst_width; ++x) {
+            int x0 = 2 * x;
+            int x1 = std::min(x0 + 1, src_width - 1);
+            for (int c = 0; c < channels; ++c) {
+                int sum = row0[x0 * channels + c] + row0[x1 * channels + c] + row1[x0 * channels + c] + row1[x1 * channels + c];
+                dst[x * channels + c] = static_cast<unsigned char>((sum + 2) >> 2);
+            }
+        }
+    }
+
+    void SrgbRow(const unsigned char* row0, const unsigned char* row1, int src_width, int channels,
+        unsigned char* dst, int dst_width) {
+        const SrgbTables& tables = GetSrgbTables();
+        // 單通道與 RGB 沒有 alpha，其他情況下最後一個通道是 alpha，維持線性平均
+        int color_channels = (channels == 2 || channels == 4) ? channels - 1 : channels;
+
+        for (int x = 0; x < dst_width; ++x) {
+            int x0 = 2 * x;
+            int x1 = std::min(x0 + 1, src_width - 1);
+            for (int c = 0; c < channels; ++c) {
+                const unsigned char a = row0[x0 * channels + c];
+                const unsigned char b = row0[x1 * channels + c];
+                const unsigned char d = row1[x0 * channels + c];
+                const unsigned char e = row1[x1 * channels + c];
+                if (c < color_channels) {
+                    float linear = (tables.to_linear[a] + tables.to_linear[b] + tables.to_linear[d] + tables.to_linear[e]) * 0.25f;
+                    dst[x * channels + c] = tables.to_srgb[static_cast<int>(linear * (kLinearToSrgbSize - 1) + 0.5f)];
+                } else {
+                    dst[x * channels + c] = static_cast<unsigned char>((a + b + d + e + 2) >> 2);
+                }
+            }
+        }
+    }
+
+#ifdef MIPMAP_SSE2
+    // 兩列各 4 個 RGBA 像素 -> 2 個輸出像素（16-bit 累加後 (sum + 2) >> 2）
+    inline __m128i BoxRgba2(__m128i top, __m128i bottom) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+        // lo = [p0, p1]，把 p1 移到 p0 的位置相加就是左右兩個像素的和
+        lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+        hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+        return _mm_unpacklo_epi64(lo, hi);
+    }
+
+    int BoxRowRgbaSse2(const unsigned char* row0, const unsigned char* row1, unsigned char* dst, int dst_width) {
+        const __m128i round = _mm_set1_epi16(2);
+        int x = 0;
+        for (; x + 4 <= dst_width; x += 4) {
+            const unsigned char* s0 = row0 + x * 8;
+            const unsigned char* s1 = row1 + x * 8;
+            __m128i a = BoxRgba2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s0)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1)));
+            __m128i b = BoxRgba2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s0 + 16)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + 16)));
+            a = _mm_srli_epi16(_mm_add_epi16(a, round), 2);
+            b = _mm_srli_epi16(_mm_add_epi16(b, round), 2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packus_epi16(a, b));
+        }
+        return x;
+    }
+
+    int BoxRowR8Sse2(const unsigned char* row0, const unsigned char* row1, unsigned char* dst, int dst_width) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128i round = _mm_set1_epi32(2);
+        int x = 0;
+        for (; x + 8 <= dst_width; x += 8) {
+            __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 2));
+            __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 2));
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+            // madd 與 1 相乘等於把相鄰兩個 16-bit 相加成 32-bit
+            lo = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(lo, ones), round), 2);
+            hi = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(hi, ones), round), 2);
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(lo, hi), zero);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), packed);
+        }
+        return x;
+    }
+#endif
+
+    void BoxRow(const unsigned char* row0, const unsigned char* row1, int src_width, int channels,
+        unsigned char* dst, int dst_width) {
+        int x = 0;
+#ifdef MIPMAP_SSE2
+        // 寬度為 1 時 x1 必須 clamp，交給 scalar 版本處理
+        if (src_width >= 2) {
+            if (channels == 4) {
+                x = BoxRowRgbaSse2(row0, row1, dst, dst_width);
+            } else if (channels == 1) {
+                x = BoxRowR8Sse2(row0, row1, dst, dst_width);
+            }
+        }
+#endif
+        BoxRowScalar(row0, row1, src_width, channels, dst, x, dst_width);
+    }
+}
+
+namespace mipmap {
+    int LevelCount(int width, int height) {
+        int levels = 1;
+        int size = std::max(width, height);
+        while (size > 1) {
+            size /= 2;
+            ++levels;
+        }
+        return levels;
+    }
+
+    void Downsample(const unsigned char* src, int width, int height, int channels, unsigned char* dst, MipmapFilter filter) {
+        int dst_width = std::max(1, width / 2);
+        int dst_height = std::max(1, height / 2);
+        std::size_t src_pitch = static_cast<std::size_t>(width) * channels;
+        std::size_t dst_pitch = static_cast<std::size_t>(dst_width) * channels;
+
+        for (int y = 0; y < dst_height; ++y) {
+            const unsigned char* row0 = src + static_cast<std::size_t>(2 * y) * src_pitch;
+            const unsigned char* row1 = src + static_cast<std::size_t>(std::min(2 * y + 1, height - 1)) * src_pitch;
+            unsigned char* out = dst + static_cast<std::size_t>(y) * dst_pitch;
+
+            if (filter == MipmapFilter::SrgbBox) {
+                SrgbRow(row0, row1, width, channels, out, dst_width);
+            } else {
+                BoxRow(row0, row1, width, channels, out, dst_width);
+            }
+        }
+    }
+
+    void Generate(Image& image, MipmapFilter filter) {
+        image.mipmaps.clear();
+        if (!image.IsValid() || filter == MipmapFilter::Driver) {
+            return;
+        }
+        PROFILE_ZONE("Generate mipmaps");
+
+        int width = image.width;
+        int height = image.height;
+        const unsigned char* src = image.pixels.get();
+        int levels = LevelCount(width, height);
+        image.mipmaps.reserve(levels - 1);
+
+        for (int level = 1; level < levels; ++level) {
+            int dst_width = std::max(1, width / 2);
+            int dst_height = std::max(1, height / 2);
+            std::shared_ptr<unsigned char> dst(new unsigned char[static_cast<std::size_t>(dst_width) * dst_height * image.channels],
+                std::default_delete<unsigned char[]>());
+
+            Downsample(src, width, height, image.channels, dst.get(), filter);
+            image.mipmaps.push_back({ dst_width, dst_height, dst });
+
+            src = dst.get();
+            width = dst_width;
+            height = dst_height;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#include "OffscreenTarget.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+OffscreenTarget::OffscreenTarget(int width, int height) :
+    width(width),
+    height(height),
+    m_framebuffer(0),
+    m_color(0),
+    m_depth(0) {
+    glGenRenderbuffers(1, &m_color);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Offscreen framebuffer is incomplete" << std::endl;
+        exit(-1);
+    }
+}
+
+OffscreenTarget::~OffscreenTarget() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(1, &m_color);
+    glDeleteRenderbuffers(1, &m_depth);
+}
+
+void OffscreenTarget::Bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+}
+
+namespace offscreen {
+    bool WritePpm(const std::string& filename, int width, int height) {
+        std::vector<unsigned char> pixels(static_cast<std::size_t>(width) * height * 3);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+        std::ofstream file(filename, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        // OpenGL 的原點在左下角，PPM 是從最上面一列開始存
+        file << "P6\n" << width << " " << height << "\n255\n";
+        const std::size_t row_size = static_cast<std::size_t>(width) * 3;
+        for (int y = height - 1; y >= 0; --y) {
+            file.write(reinterpret_cast<const char*>(pixels.data() + y * row_size), row_size);
+        }
+        return static_cast<bool>(file);
+    }
+
+    void DumpFrame(const std::string& directory, int frame, int width, int height) {
+        std::filesystem::create_directories(directory);
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%05d.ppm", frame);
+        std::string filename = (std::filesystem::path(directory) / name).string();
+        if (!WritePpm(filename, width, height)) {
+            std::cerr << "Failed to write " << filename << std::endl;
+        }
+    }
+}
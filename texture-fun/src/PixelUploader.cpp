@@ -0,0 +1,223 @@
+#include "PixelUploader.hpp"
+
+#include "GLFeatures.hpp"
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+    // 讓每段資料都從 cache line 開始，也滿足任何 pixel type 的對齊需求
+    constexpr std::size_t kAlignment = 64;
+
+    std::size_t AlignUp(std::size_t value) {
+        return (value + kAlignment - 1) & ~(kAlignment - 1);
+    }
+}
+
+PixelUploader::PixelUploader(std::size_t capacity, bool readable) :
+    m_capacity(AlignUp(capacity)),
+    m_head(0),
+    m_buffer(0),
+    m_mapped(nullptr),
+    m_initialized(false),
+    m_persistent(false),
+    m_readable(readable),
+    m_range_mapped(false) {}
+
+PixelUploader::~PixelUploader() {
+    Shutdown();
+}
+
+void PixelUploader::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+    for (const auto& fence : m_in_flight) {
+        glDeleteSync(fence.sync);
+    }
+    m_in_flight.clear();
+    if (m_persistent || m_range_mapped) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &m_buffer);
+
+    m_head = 0;
+    m_buffer = 0;
+    m_mapped = nullptr;
+    m_initialized = false;
+    m_persistent = false;
+    m_range_mapped = false;
+}
+
+PixelUploader& PixelUploader::Default() {
+    static PixelUploader uploader;
+    return uploader;
+}
+
+// 第一次使用時才建立 buffer，因為建構時不一定已經有 GL context
+void PixelUploader::Initialize() {
+    if (m_initialized) {
+        return;
+    }
+    m_initialized = true;
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+    if (gl_features::BufferStorage()) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | (m_readable ? GL_MAP_READ_BIT : 0);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(m_capacity), nullptr, flags);
+        m_mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(m_capacity), flags));
+        m_persistent = m_mapped != nullptr;
+        if (!m_persistent) {
+            // storage 是 immutable 的，map 失敗時只能重新建立一個 buffer 走 orphaning
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glDeleteBuffers(1, &m_buffer);
+            glGenBuffers(1, &m_buffer);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        }
+    }
+#endif
+
+    if (!m_persistent) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(m_capacity), nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    std::cout << "Pixel upload ring:     " << (m_capacity >> 20) << " MB, "
+              << (m_persistent ? "persistent mapping" : "buffer orphaning") << std::endl;
+}
+
+PixelUploader::Staging PixelUploader::Allocate(std::size_t size) {
+    Staging staging;
+    std::size_t aligned = AlignUp(size);
+    if (!enabled || size == 0 || aligned > m_capacity) {
+        return staging;
+    }
+    Initialize();
+
+    bool wrapped = m_head + aligned > m_capacity;
+    if (wrapped) {
+        m_head = 0;
+    }
+
+    if (m_persistent) {
+        WaitForRange(m_head, m_head + aligned);
+        staging.data = m_mapped + m_head;
+    } else {
+        // 繞回開頭時 orphan 整個 buffer，driver 會給一塊新的記憶體，GPU 仍可繼續讀取舊的那塊
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        if (wrapped) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(m_capacity), nullptr, GL_STREAM_DRAW);
+        }
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        staging.data = static_cast<unsigned char*>(
+            glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, static_cast<GLintptr>(m_head), static_cast<GLsizeiptr>(aligned), flags));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (staging.data == nullptr) {
+            return staging;
+        }
+        m_range_mapped = true;
+    }
+
+    staging.offset = m_head;
+    staging.size = aligned;
+    m_head += aligned;
+    return staging;
+}
+
+void PixelUploader::WaitForRange(std::size_t begin, std::size_t end) {
+    // GPU 依序完成指令，所以只要等待最後一個重疊的 fence，之前的也都已經完成
+    std::size_t last = 0;
+    bool overlaps = false;
+    for (std::size_t i = 0; i < m_in_flight.size(); ++i) {
+        const Fence& fence = m_in_flight[i];
+        if (fence.begin < end && begin < fence.end) {
+            last = i;
+            overlaps = true;
+        }
+    }
+    if (!overlaps) {
+        return;
+    }
+
+    GLenum result = glClientWaitSync(m_in_flight[last].sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(m_in_flight[last].sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+    for (std::size_t i = 0; i <= last; ++i) {
+        glDeleteSync(m_in_flight.front().sync);
+        m_in_flight.pop_front();
+    }
+}
+
+void PixelUploader::Submit(const Staging& staging) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!m_persistent) {
+        return;
+    }
+
+    // 順便清掉已經完成的 fence，避免小量上傳很多次時 fence 越堆越多
+    while (!m_in_flight.empty()) {
+        GLenum result = glClientWaitSync(m_in_flight.front().sync, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(m_in_flight.front().sync);
+        m_in_flight.pop_front();
+    }
+    m_in_flight.push_back({ staging.offset, staging.offset + staging.size, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+}
+
+void PixelUploader::TexSubImage2D(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type,
+    const Staging& staging, std::size_t offset) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    if (m_range_mapped) {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        m_range_mapped = false;
+    }
+    glTexSubImage2D(target, level, 0, 0, width, height, format, type, reinterpret_cast<const void*>(staging.offset + offset));
+}
+
+void PixelUploader::TexSubImage3D(GLenum target, GLint level, GLint layer, GLsizei width, GLsizei height, GLenum format, GLenum type,
+    const Staging& staging, std::size_t offset) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    if (m_range_mapped) {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        m_range_mapped = false;
+    }
+    glTexSubImage3D(target, level, 0, 0, layer, width, height, 1, format, type, reinterpret_cast<const void*>(staging.offset + offset));
+}
+
+void PixelUploader::Upload2D(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels, std::size_t size) {
+    Staging staging = Allocate(size);
+    if (staging.data == nullptr) {
+        glTexSubImage2D(target, level, 0, 0, width, height, format, type, pixels);
+        return;
+    }
+    std::memcpy(staging.data, pixels, size);
+    TexSubImage2D(target, level, width, height, format, type, staging);
+    Submit(staging);
+}
+
+void PixelUploader::Upload3D(GLenum target, GLint level, GLint layer, GLsizei width, GLsizei height, GLenum format, GLenum type,
+    const void* pixels, std::size_t size) {
+    Staging staging = Allocate(size);
+    if (staging.data == nullptr) {
+        glTexSubImage3D(target, level, 0, 0, layer, width, height, 1, format, type, pixels);
+        return;
+    }
+    std::memcpy(staging.data, pixels, size);
+    TexSubImage3D(target, level, layer, width, height, format, type, staging);
+    Submit(staging);
+}
+
+bool PixelUploader::IsPersistent() const {
+    return m_persistent;
+}
+
+bool PixelUploader::CanRead() const {
+    return m_persistent && m_readable;
+}
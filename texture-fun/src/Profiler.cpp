@@ -0,0 +1,311 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace {
+    using profiler::Clock;
+
+    struct Event {
+        const char* name;
+        std::int64_t start;
+        std::int64_t end;
+    };
+
+    // 一個執行緒（或 GPU）的事件。只有擁有者會寫入，寫完事件之後才以 release 更新 count，
+    // 讀取的一方以 acquire 讀 count，就能看到完整的事件
+    struct Track {
+        std::string name;
+        std::uint32_t id = 0;
+        bool gpu = false;
+        std::unique_ptr<Event[]> events{ new Event[profiler::kEventsPerThread] };
+        std::atomic<std::uint64_t> count{ 0 };
+    };
+
+    // 執行緒結束後它的 track 仍然保留，輸出 trace 時才看得到
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Track>> tracks;
+    };
+
+    std::atomic<bool> g_enabled{ false };
+
+    Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    Clock::time_point Epoch() {
+        static const Clock::time_point epoch = Clock::now();
+        return epoch;
+    }
+
+    std::int64_t Nanoseconds(Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time - Epoch()).count();
+    }
+
+    Track* CreateTrack(const std::string& name, bool gpu) {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto track = std::make_unique<Track>();
+        track->id = static_cast<std::uint32_t>(registry.tracks.size());
+        track->name = name.empty() ? "Thread " + std::to_string(track->id) : name;
+        track->gpu = gpu;
+        registry.tracks.push_back(std::move(track));
+        return registry.tracks.back().get();
+    }
+
+    // track 在第一次記錄時才建立，沒有開啟 profiler 的執行緒不必配置 ring buffer
+    thread_local Track* t_track = nullptr;
+    thread_local std::string t_name;
+
+    Track& CurrentTrack() {
+        if (t_track == nullptr) {
+            t_track = CreateTrack(t_name, false);
+        }
+        return *t_track;
+    }
+
+    Track& GpuTrack() {
+        static Track* track = CreateTrack("GPU", true);
+        return *track;
+    }
+
+    void Record(Track& track, const char* name, std::int64_t start, std::int64_t end) {
+        std::uint64_t index = track.count.load(std::memory_order_relaxed);
+        track.events[index % profiler::kEventsPerThread] = { name, start, end };
+        track.count.store(index + 1, std::memory_order_release);
+    }
+
+    // 由新到舊走過保留下來的事件，visit 回傳 false 時停止
+    template <typename Visitor>
+    void VisitEvents(const Track& track, Visitor&& visit) {
+        std::uint64_t count = track.count.load(std::memory_order_acquire);
+        std::uint64_t oldest = count > profiler::kEventsPerThread ? count - profiler::kEventsPerThread : 0;
+        for (std::uint64_t i = count; i > oldest; --i) {
+            if (!visit(track.events[(i - 1) % profiler::kEventsPerThread])) {
+                break;
+            }
+        }
+    }
+
+    std::vector<const Track*> SnapshotTracks() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<const Track*> tracks;
+        for (const auto& track : registry.tracks) {
+            tracks.push_back(track.get());
+        }
+        return tracks;
+    }
+
+    std::string Escape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+}
+
+namespace profiler {
+    void SetEnabled(bool enabled) {
+        Epoch();
+        g_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool IsEnabled() {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetThreadName(const std::string& name) {
+        t_name = name;
+        if (t_track != nullptr) {
+            std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+            t_track->name = name;
+        }
+    }
+
+    ScopedZone::ScopedZone(const char* name) : m_name(IsEnabled() ? name : nullptr) {
+        if (m_name) {
+            m_start = Clock::now();
+        }
+    }
+
+    ScopedZone::~ScopedZone() {
+        if (m_name) {
+            Record(CurrentTrack(), m_name, Nanoseconds(m_start), Nanoseconds(Clock::now()));
+        }
+    }
+
+    GpuProfiler::GpuProfiler() : m_pools{}, m_current(0), m_open(false), m_stalls(0) {
+        for (Pool& pool : m_pools) {
+            glGenQueries(static_cast<GLsizei>(MaxZonesPerFrame), pool.queries);
+        }
+    }
+
+    GpuProfiler::~GpuProfiler() {
+        for (Pool& pool : m_pools) {
+            glDeleteQueries(static_cast<GLsizei>(MaxZonesPerFrame), pool.queries);
+        }
+    }
+
+    void GpuProfiler::BeginFrame() {
+        m_current ^= 1;
+        Resolve(m_pools[m_current]);
+    }
+
+    void GpuProfiler::Begin(const char* name) {
+        Pool& pool = m_pools[m_current];
+        if (!IsEnabled() || m_open || pool.count == MaxZonesPerFrame) {
+            return;
+        }
+        pool.names[pool.count] = name;
+        pool.issued[pool.count] = Clock::now();
+        glBeginQuery(GL_TIME_ELAPSED, pool.queries[pool.count]);
+        m_open = true;
+    }
+
+    void GpuProfiler::End() {
+        if (!m_open) {
+            return;
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+        ++m_pools[m_current].count;
+        m_open = false;
+    }
+
+    void GpuProfiler::Finish() {
+        // 另一組 pool 是上一個 frame 的，比較舊，先讀
+        Resolve(m_pools[m_current ^ 1]);
+        Resolve(m_pools[m_current]);
+    }
+
+    std::size_t GpuProfiler::Stalls() const {
+        return m_stalls;
+    }
+
+    void GpuProfiler::Resolve(Pool& pool) {
+        if (pool.count == 0) {
+            return;
+        }
+
+        // query 依序完成，只要最後一個好了，前面的一定也好了
+        GLint available = 0;
+        glGetQueryObjectiv(pool.queries[pool.count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            ++m_stalls;
+        }
+
+        // GL_TIME_ELAPSED 只有長度，沒有開始時間；以送出 query 的 CPU 時間為起點，並接在前一個 zone 之後
+        Track& track = GpuTrack();
+        std::int64_t previous_end = 0;
+        for (std::size_t i = 0; i < pool.count; ++i) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(pool.queries[i], GL_QUERY_RESULT, &elapsed);
+            std::int64_t start = std::max(Nanoseconds(pool.issued[i]), previous_end);
+            previous_end = start + static_cast<std::int64_t>(elapsed);
+            Record(track, pool.names[i], start, previous_end);
+        }
+        pool.count = 0;
+    }
+
+    ScopedGpuZone::ScopedGpuZone(GpuProfiler* profiler, const char* name) : m_profiler(profiler) {
+        if (m_profiler) {
+            m_profiler->Begin(name);
+        }
+    }
+
+    ScopedGpuZone::~ScopedGpuZone() {
+        if (m_profiler) {
+            m_profiler->End();
+        }
+    }
+
+    std::vector<ZoneTotal> Summarize(Clock::time_point from, Clock::time_point to) {
+        std::int64_t begin = Nanoseconds(from);
+        std::int64_t end = Nanoseconds(to);
+
+        std::map<std::pair<bool, std::string>, ZoneTotal> totals;
+        for (const Track* track : SnapshotTracks()) {
+            // 事件依結束時間的順序寫入，所以往回走到比 from 早就可以停了
+            VisitEvents(*track, [&](const Event& event) {
+                if (event.end < begin) {
+                    return false;
+                }
+                if (event.end < end) {
+                    ZoneTotal& total = totals[{ track->gpu, event.name }];
+                    total.name = event.name;
+                    total.gpu = track->gpu;
+                    total.calls += 1;
+                    total.milliseconds += static_cast<double>(event.end - event.start) / 1.0e6;
+                }
+                return true;
+            });
+        }
+
+        std::vector<ZoneTotal> result;
+        for (auto& entry : totals) {
+            result.push_back(std::move(entry.second));
+        }
+        std::sort(result.begin(), result.end(), [](const ZoneTotal& a, const ZoneTotal& b) {
+            return a.gpu != b.gpu ? !a.gpu : a.milliseconds > b.milliseconds;
+        });
+        return result;
+    }
+
+    void PrintSummary(Clock::time_point from, Clock::time_point to, int frames) {
+        if (frames <= 0) {
+            return;
+        }
+
+        std::cout << "Profile (" << frames << " frames, average per frame):" << std::endl;
+        for (const ZoneTotal& total : Summarize(from, to)) {
+            std::cout << "  " << (total.gpu ? "GPU " : "CPU ") << std::left << std::setw(24) << total.name << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(9) << total.milliseconds / frames << " ms"
+                      << std::setprecision(1) << std::setw(8) << static_cast<double>(total.calls) / frames << " calls"
+                      << std::defaultfloat << std::endl;
+        }
+    }
+
+    bool WriteChromeTrace(const std::string& filename) {
+        std::ofstream file(filename);
+        if (!file) {
+            std::cout << "Failed to write trace: " << filename << std::endl;
+            return false;
+        }
+
+        // Chrome trace 的時間單位是微秒；GPU 另外放在一個 process 底下，跟 CPU 的執行緒分開顯示
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        bool first = true;
+        char timing[64];
+        for (const Track* track : SnapshotTracks()) {
+            int pid = track->gpu ? 2 : 1;
+            file << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid
+                 << ", \"tid\": " << track->id << ", \"args\": {\"name\": \"" << Escape(track->name) << "\"}}";
+            first = false;
+
+            VisitEvents(*track, [&](const Event& event) {
+                std::snprintf(timing, sizeof(timing), "\"ts\": %.3f, \"dur\": %.3f", event.start / 1000.0,
+                    (event.end - event.start) / 1000.0);
+                file << ",\n{\"name\": \"" << Escape(event.name) << "\", \"cat\": \"" << (track->gpu ? "gpu" : "cpu")
+                     << "\", \"ph\": \"X\", \"pid\": " << pid << ", \"tid\": " << track->id << ", " << timing << "}";
+                return true;
+            });
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+}
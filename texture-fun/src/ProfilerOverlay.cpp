@@ -0,0 +1,45 @@
+#ifdef TEXTURE_FUN_PROFILER_OVERLAY
+
+#include "Profiler.hpp"
+
+#include <imgui.h>
+
+namespace profiler {
+    void DrawOverlay() {
+        // 每半秒取一次平均，數字才不會跳得看不清楚。GPU 的結果晚兩個 frame 才讀回來，
+        // 所以顯示的是上一段已經完整的時間，而不是剛結束的這一段
+        static Clock::time_point previous_start = Clock::now();
+        static Clock::time_point window_start = previous_start;
+        static int previous_frames = 0;
+        static int window_frames = 0;
+        static std::vector<ZoneTotal> totals;
+        static int total_frames = 1;
+
+        ++window_frames;
+        Clock::time_point now = Clock::now();
+        if (now - window_start >= std::chrono::milliseconds(500)) {
+            if (previous_frames > 0) {
+                totals = Summarize(previous_start, window_start);
+                total_frames = previous_frames;
+            }
+            previous_start = window_start;
+            previous_frames = window_frames;
+            window_start = now;
+            window_frames = 0;
+        }
+
+        ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowBgAlpha(0.6f);
+        ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing);
+        if (!IsEnabled()) {
+            ImGui::TextUnformatted("Profiling is disabled");
+        }
+        for (const ZoneTotal& total : totals) {
+            ImGui::Text("%s %-24s %8.3f ms %6.1f calls", total.gpu ? "GPU" : "CPU", total.name.c_str(),
+                total.milliseconds / total_frames, static_cast<double>(total.calls) / total_frames);
+        }
+        ImGui::End();
+    }
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "ProgramCache.hpp"
+
+#include "GLFeatures.hpp"
+#include "Hash.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char kMagic[4] = { 'P', 'R', 'G', 'B' };
+
+    struct CacheHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t key;
+        std::uint32_t format;
+        std::uint32_t length;
+    };
+
+    std::uint64_t HashGLString(GLenum name, std::uint64_t seed) {
+        const char* text = reinterpret_cast<const char*>(glGetString(name));
+        // 明確轉成 string_view：直接傳 const char* 會選到 (const void*, size) 的版本，把 seed 當成長度
+        return hash::Fnv1a(std::string_view(text ? text : ""), seed);
+    }
+}
+
+ProgramCache::ProgramCache(const std::string& directory) : m_directory(directory) {}
+
+ProgramCache& ProgramCache::Default() {
+    static ProgramCache cache;
+    return cache;
+}
+
+std::uint64_t ProgramCache::Key(const std::vector<std::string>& sources) const {
+    std::uint64_t key = hash::Fnv1a(&kVersion, sizeof(kVersion));
+    key = HashGLString(GL_VENDOR, key);
+    key = HashGLString(GL_RENDERER, key);
+    key = HashGLString(GL_VERSION, key);
+    for (const auto& source : sources) {
+        // 連同長度一起雜湊，避免不同的切分方式得到相同的 key
+        std::uint64_t length = source.size();
+        key = hash::Fnv1a(&length, sizeof(length), key);
+        key = hash::Fnv1a(source, key);
+    }
+    return key;
+}
+
+bool ProgramCache::Load(std::uint64_t key, GLuint program) {
+    if (!gl_features::ProgramBinary()) {
+        ++misses;
+        return false;
+    }
+
+    std::ifstream file(CachePath(key), std::ios::binary);
+    CacheHeader header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.key != key) {
+        ++misses;
+        return false;
+    }
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) {
+        ++misses;
+        return false;
+    }
+
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    return true;
+}
+
+void ProgramCache::Store(std::uint64_t key, GLuint program) {
+    if (!gl_features::ProgramBinary()) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.key = key;
+    std::vector<char> binary(static_cast<std::size_t>(length));
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    header.format = format;
+    header.length = static_cast<std::uint32_t>(length);
+
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+    if (error) {
+        std::cerr << "[Warning] Failed to create shader cache directory: " << m_directory << std::endl;
+        return;
+    }
+
+    // 先寫到暫存檔再改名，避免另一個同時啟動的行程讀到寫到一半的檔案
+    std::string cache_path = CachePath(key);
+    std::string temp_path = cache_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "[Warning] Failed to write shader cache: " << cache_path << std::endl;
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), header.length);
+    }
+    fs::rename(temp_path, cache_path, error);
+    if (error) {
+        fs::remove(temp_path, error);
+    }
+}
+
+std::string ProgramCache::CachePath(std::uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (fs::path(m_directory) / name).string();
+}
@@ -0,0 +1,136 @@
+#include "QuadRenderer.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+    const float kVertices[] = {
+        // Position             // Texture
+        -0.5f, -0.5f, 0.0f,     0.0f, 0.0f,
+         0.5f, -0.5f, 0.0f,     1.0f, 0.0f,
+         0.5f,  0.5f, 0.0f,     1.0f, 1.0f,
+        -0.5f,  0.5f, 0.0f,     0.0f, 1.0f,
+    };
+
+    const unsigned int kIndices[] = {
+        0, 1, 2,
+        0, 2, 3,
+    };
+
+    constexpr GLuint kModelLocation = 2;
+    constexpr GLuint kLayerLocation = 6;
+}
+
+QuadRenderer::QuadRenderer(std::size_t max_instances) :
+    m_vao(0),
+    m_vertex_buffer(0),
+    m_index_buffer(0),
+    m_instance_buffer(0),
+    m_max_instances(max_instances),
+    m_draw_calls(0) {
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vertex_buffer);
+    glGenBuffers(1, &m_index_buffer);
+    glGenBuffers(1, &m_instance_buffer);
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(kVertices), kVertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(kIndices), kIndices, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<const void*>(0));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<const void*>(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // mat4 佔用連續四個 attribute location，每個 instance 前進一次
+    glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_max_instances * sizeof(Instance)), nullptr, GL_STREAM_DRAW);
+    for (GLuint column = 0; column < 4; ++column) {
+        glEnableVertexAttribArray(kModelLocation + column);
+        glVertexAttribDivisor(kModelLocation + column, 1);
+    }
+    glEnableVertexAttribArray(kLayerLocation);
+    glVertexAttribDivisor(kLayerLocation, 1);
+    SetInstanceOffset(0);
+
+    glBindVertexArray(0);
+}
+
+QuadRenderer::~QuadRenderer() {
+    glDeleteBuffers(1, &m_instance_buffer);
+    glDeleteBuffers(1, &m_index_buffer);
+    glDeleteBuffers(1, &m_vertex_buffer);
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+std::size_t QuadRenderer::AddMaterial(Shader& shader, GLenum texture_target, GLuint texture, GLuint sampler) {
+    m_materials.push_back({ &shader, texture_target, texture, sampler, {} });
+    return m_materials.size() - 1;
+}
+
+void QuadRenderer::SetTexture(std::size_t material, GLuint texture) {
+    m_materials[material].texture = texture;
+}
+
+void QuadRenderer::Submit(std::size_t material, const glm::mat4& model, float layer) {
+    m_materials[material].instances.push_back({ model, layer });
+}
+
+// GL 3.3 沒有 base instance，所以每個 batch 重新指定 instance attribute 在 buffer 中的起點
+void QuadRenderer::SetInstanceOffset(std::size_t first_instance) {
+    const std::uintptr_t base = first_instance * sizeof(Instance);
+    for (GLuint column = 0; column < 4; ++column) {
+        glVertexAttribPointer(kModelLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+            reinterpret_cast<const void*>(base + offsetof(Instance, model) + column * sizeof(glm::vec4)));
+    }
+    glVertexAttribPointer(kLayerLocation, 1, GL_FLOAT, GL_FALSE, sizeof(Instance),
+        reinterpret_cast<const void*>(base + offsetof(Instance, layer)));
+}
+
+void QuadRenderer::Flush() {
+    PROFILE_ZONE("Draw quads");
+    m_draw_calls = 0;
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+
+    // 每個 frame 先 orphan 整個 buffer，driver 會換一塊新的記憶體，不必等 GPU 讀完上一個 frame 的資料
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_max_instances * sizeof(Instance)), nullptr, GL_STREAM_DRAW);
+
+    std::size_t first_instance = 0;
+    for (auto& material : m_materials) {
+        std::size_t count = std::min(material.instances.size(), m_max_instances - first_instance);
+        if (count < material.instances.size()) {
+            std::cerr << "QuadRenderer: more than " << m_max_instances << " instances in one frame" << std::endl;
+        }
+        if (count == 0) {
+            material.instances.clear();
+            continue;
+        }
+
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first_instance * sizeof(Instance)),
+            static_cast<GLsizeiptr>(count * sizeof(Instance)), material.instances.data());
+        SetInstanceOffset(first_instance);
+
+        material.shader->Use();
+        glBindTexture(material.texture_target, material.texture);
+        glBindSampler(0, material.sampler);
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+        ++m_draw_calls;
+
+        first_instance += count;
+        material.instances.clear();
+    }
+
+    glBindSampler(0, 0);
+    glBindVertexArray(0);
+}
+
+std::size_t QuadRenderer::DrawCalls() const {
+    return m_draw_calls;
+}
@@ -0,0 +1,61 @@
+#include "Sampler.hpp"
+#include "GLFeatures.hpp"
+
+#include <algorithm>
+
+namespace {
+    // ARB / EXT_texture_filter_anisotropic 與 GL 4.6 共用相同的數值，glad 沒有產生這個擴充時也能編譯
+    constexpr GLenum kTextureMaxAnisotropy = 0x84FE;
+    constexpr GLenum kMaxTextureMaxAnisotropy = 0x84FF;
+}
+
+bool SamplerState::operator==(const SamplerState& other) const {
+    return wrap_s == other.wrap_s && wrap_t == other.wrap_t && min_filter == other.min_filter &&
+           mag_filter == other.mag_filter && anisotropy == other.anisotropy;
+}
+
+SamplerCache::SamplerCache() : m_max_anisotropy(1.0f) {
+    if (gl_features::TextureFilterAnisotropic()) {
+        glGetFloatv(kMaxTextureMaxAnisotropy, &m_max_anisotropy);
+        m_max_anisotropy = std::max(1.0f, m_max_anisotropy);
+    }
+}
+
+SamplerCache::~SamplerCache() {
+    for (const Entry& entry : m_samplers) {
+        glDeleteSamplers(1, &entry.sampler);
+    }
+}
+
+GLuint SamplerCache::Get(const SamplerState& requested) {
+    // 先把 anisotropy 夾到 context 支援的範圍，超出範圍的兩個要求才會共用同一個 sampler
+    SamplerState state = requested;
+    state.anisotropy = std::clamp(state.anisotropy, 1.0f, m_max_anisotropy);
+
+    // sampler 的種類很少，線性搜尋就夠了
+    for (const Entry& entry : m_samplers) {
+        if (entry.state == state) {
+            return entry.sampler;
+        }
+    }
+
+    GLuint sampler = 0;
+    glGenSamplers(1, &sampler);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, static_cast<GLint>(state.wrap_s));
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, static_cast<GLint>(state.wrap_t));
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(state.min_filter));
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(state.mag_filter));
+    if (state.anisotropy > 1.0f) {
+        glSamplerParameterf(sampler, kTextureMaxAnisotropy, state.anisotropy);
+    }
+    m_samplers.push_back({ state, sampler });
+    return sampler;
+}
+
+float SamplerCache::MaxAnisotropy() const {
+    return m_max_anisotropy;
+}
+
+std::size_t SamplerCache::Size() const {
+    return m_samplers.size();
+}
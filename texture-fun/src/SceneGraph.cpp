@@ -0,0 +1,170 @@
+#include "SceneGraph.hpp"
+#include "MatrixMath.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    // 每個 job 處理的節點數，太小的話 ThreadPool 排程的成本會蓋過矩陣運算
+    constexpr std::size_t kNodesPerJob = 4096;
+}
+
+SceneGraph::SceneGraph(ThreadPool* pool) : m_pool(pool), m_first_dirty(0) {
+}
+
+std::uint32_t SceneGraph::AddNode(std::uint32_t parent, const glm::mat4& local) {
+    std::uint32_t node = static_cast<std::uint32_t>(m_local.size());
+    if (parent != NoParent && parent >= node) {
+        std::cerr << "SceneGraph: parent " << parent << " does not exist, node " << node << " becomes a root" << std::endl;
+        parent = NoParent;
+    }
+
+    std::uint32_t depth = parent == NoParent ? 0 : m_depth[parent] + 1;
+    m_local.push_back(local);
+    m_world.push_back(local);
+    m_parent.push_back(parent);
+    m_dirty.push_back(1);
+    m_material.push_back(NoMaterial);
+    m_layer.push_back(0.0f);
+    m_center_x.push_back(0.0f);
+    m_center_y.push_back(0.0f);
+    m_center_z.push_back(0.0f);
+    m_extent_x.push_back(0.0f);
+    m_extent_y.push_back(0.0f);
+    m_extent_z.push_back(0.0f);
+    m_visible.push_back(1);
+    m_depth.push_back(depth);
+    if (depth >= m_levels.size()) {
+        m_levels.resize(depth + 1);
+    }
+    m_levels[depth].push_back(node);
+    MarkDirty(node);
+    return node;
+}
+
+void SceneGraph::SetLocal(std::uint32_t node, const glm::mat4& local) {
+    m_local[node] = local;
+    MarkDirty(node);
+}
+
+void SceneGraph::SetTransform(std::uint32_t node, const glm::vec3& translation, float radians, const glm::vec3& axis,
+    const glm::vec3& factor) {
+    glm::mat4& local = m_local[node];
+    local = glm::mat4(1.0f);
+    matrix::Translate(local, translation);
+    if (radians != 0.0f) {
+        matrix::Rotate(local, radians, axis);
+    }
+    matrix::Scale(local, factor);
+    MarkDirty(node);
+}
+
+void SceneGraph::SetMaterial(std::uint32_t node, std::size_t material, float layer) {
+    m_material[node] = material;
+    m_layer[node] = layer;
+}
+
+const glm::mat4& SceneGraph::Local(std::uint32_t node) const {
+    return m_local[node];
+}
+
+const glm::mat4& SceneGraph::World(std::uint32_t node) const {
+    return m_world[node];
+}
+
+std::size_t SceneGraph::Size() const {
+    return m_local.size();
+}
+
+std::size_t SceneGraph::Update() {
+    PROFILE_ZONE("Scene update");
+
+    const std::size_t count = m_local.size();
+    const std::size_t first = m_first_dirty;
+    if (first >= count) {
+        return 0;
+    }
+
+    // parent 的編號一定比較小，依序走一遍就能讓整棵被修改的子樹都標記為 dirty
+    std::size_t updated = 0;
+    for (std::size_t i = first; i < count; ++i) {
+        std::uint32_t parent = m_parent[i];
+        if (parent != NoParent) {
+            m_dirty[i] |= m_dirty[parent];
+        }
+        updated += m_dirty[i];
+    }
+
+    // 同一層的節點只依賴上一層的 world matrix，所以每一層內部可以平行計算，層與層之間要等待
+    for (const auto& level : m_levels) {
+        const std::uint32_t* begin = std::lower_bound(level.data(), level.data() + level.size(), first);
+        const std::size_t size = static_cast<std::size_t>(level.data() + level.size() - begin);
+        if (m_pool == nullptr || m_pool->Size() <= 1 || size < kNodesPerJob * 2) {
+            UpdateRange(begin, size);
+            continue;
+        }
+
+        for (std::size_t offset = 0; offset < size; offset += kNodesPerJob) {
+            const std::uint32_t* nodes = begin + offset;
+            std::size_t n = std::min(kNodesPerJob, size - offset);
+            m_pool->Submit([this, nodes, n] { UpdateRange(nodes, n); });
+        }
+        m_pool->Wait();
+    }
+
+    std::fill(m_dirty.begin() + first, m_dirty.end(), 0);
+    m_first_dirty = count;
+    return updated;
+}
+
+void SceneGraph::MarkDirty(std::uint32_t node) {
+    m_dirty[node] = 1;
+    m_first_dirty = std::min<std::size_t>(m_first_dirty, node);
+}
+
+void SceneGraph::UpdateRange(const std::uint32_t* nodes, std::size_t count) {
+    PROFILE_ZONE("Update world matrices");
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t node = nodes[i];
+        if (!m_dirty[node]) {
+            continue;
+        }
+        std::uint32_t parent = m_parent[node];
+        if (parent == NoParent) {
+            m_world[node] = m_local[node];
+        } else {
+            matrix::Multiply(m_world[parent], m_local[node], m_world[node]);
+        }
+
+        // 單位四邊形的四個角為 (±0.5, ±0.5, 0)，轉換後的 AABB 半邊長為 0.5 * (|column 0| + |column 1|)
+        const glm::mat4& world = m_world[node];
+        m_center_x[node] = world[3].x;
+        m_center_y[node] = world[3].y;
+        m_center_z[node] = world[3].z;
+        m_extent_x[node] = 0.5f * (std::fabs(world[0].x) + std::fabs(world[1].x));
+        m_extent_y[node] = 0.5f * (std::fabs(world[0].y) + std::fabs(world[1].y));
+        m_extent_z[node] = 0.5f * (std::fabs(world[0].z) + std::fabs(world[1].z));
+    }
+}
+
+std::size_t SceneGraph::Submit(QuadRenderer& renderer, const Frustum* frustum) {
+    PROFILE_ZONE("Cull and submit");
+    const std::size_t count = m_local.size();
+    if (frustum != nullptr) {
+        culling::CullAabbs(*frustum, m_center_x.data(), m_center_y.data(), m_center_z.data(), m_extent_x.data(),
+            m_extent_y.data(), m_extent_z.data(), count, m_visible.data());
+    } else {
+        std::fill(m_visible.begin(), m_visible.end(), 1);
+    }
+
+    std::size_t submitted = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (m_visible[i] && m_material[i] != NoMaterial) {
+            renderer.Submit(m_material[i], m_world[i], m_layer[i]);
+            ++submitted;
+        }
+    }
+    return submitted;
+}
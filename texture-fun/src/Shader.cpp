@@ -1,16 +1,41 @@
 #include "Shader.hpp"
 
+#include "GLFeatures.hpp"
+#include "ProgramCache.hpp"
+
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 Shader::Shader(const std::string& vertex_path, const std::string& fragment_path) {
-    GLuint vertex = CreateShader(vertex_path, ShaderType::Vert);
-    GLuint fragment = CreateShader(fragment_path, ShaderType::Frag);
+    std::string vertex_source = ReadSource(vertex_path);
+    std::string fragment_source = ReadSource(fragment_path);
 
     m_id = glCreateProgram();
+
+    // 同樣的原始碼在同一個 driver 上 link 過的話，直接載入快取的 program binary
+    ProgramCache& cache = ProgramCache::Default();
+    std::uint64_t key = cache.Key({ vertex_source, fragment_source });
+    if (!cache.Load(key, m_id)) {
+        LinkFromSource(vertex_source, fragment_source);
+        cache.Store(key, m_id);
+    }
+
+    ReflectUniforms();
+    ReflectUniformBlocks();
+}
+
+void Shader::LinkFromSource(const std::string& vertex_source, const std::string& fragment_source) {
+    GLuint vertex = CreateShader(vertex_source, ShaderType::Vert);
+    GLuint fragment = CreateShader(fragment_source, ShaderType::Frag);
+
     glAttachShader(m_id, vertex);
     glAttachShader(m_id, fragment);
+    if (gl_features::ProgramBinary()) {
+        glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(m_id);
 
     if (LinkShaderProgram(m_id) != GL_TRUE) {
@@ -23,6 +48,8 @@ Shader::Shader(const std::string& vertex_path, const std::string& fragment_path)
         exit(-1);
     }
 
+    glDetachShader(m_id, vertex);
+    glDetachShader(m_id, fragment);
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 }
@@ -65,7 +92,49 @@ void Shader::SetMat4(const std::string& uniform_name, const glm::mat4& matrix) {
     glUniformMatrix4fv(GetUniformLocation(uniform_name), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
-GLuint Shader::CreateShader(const std::string& shader_filepath, ShaderType shader_type) {
+void Shader::SetInt(UniformHandle uniform, int value) {
+    glUniform1i(GetUniformLocation(uniform), value);
+}
+
+void Shader::SetBool(UniformHandle uniform, bool value) {
+    glUniform1i(GetUniformLocation(uniform), value);
+}
+
+void Shader::SetFloat(UniformHandle uniform, float value) {
+    glUniform1f(GetUniformLocation(uniform), value);
+}
+
+void Shader::SetVec2(UniformHandle uniform, const glm::vec2& vector) {
+    glUniform2fv(GetUniformLocation(uniform), 1, glm::value_ptr(vector));
+}
+
+void Shader::SetVec3(UniformHandle uniform, const glm::vec3& vector) {
+    glUniform3fv(GetUniformLocation(uniform), 1, &vector[0]);
+}
+
+void Shader::SetVec4(UniformHandle uniform, const glm::vec4& vector) {
+    glUniform4fv(GetUniformLocation(uniform), 1, glm::value_ptr(vector));
+}
+
+void Shader::SetMat4(UniformHandle uniform, const glm::mat4& matrix) {
+    glUniformMatrix4fv(GetUniformLocation(uniform), 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+bool Shader::BindUniformBlock(const std::string& block_name, GLuint binding) {
+    auto it = m_uniform_blocks.find(block_name);
+    if (it == m_uniform_blocks.end()) {
+        return false;
+    }
+    glUniformBlockBinding(m_id, it->second.index, binding);
+    return true;
+}
+
+const UniformBlockLayout* Shader::GetUniformBlock(const std::string& block_name) const {
+    auto it = m_uniform_blocks.find(block_name);
+    return it == m_uniform_blocks.end() ? nullptr : &it->second;
+}
+
+std::string Shader::ReadSource(const std::string& shader_filepath) {
     std::ifstream file;
     std::string source = "";
 
@@ -77,7 +146,10 @@ GLuint Shader::CreateShader(const std::string& shader_filepath, ShaderType shade
     source.resize(std::filesystem::file_size(shader_filepath));
     file.read(source.data(), source.size());
     file.close();
+    return source;
+}
 
+GLuint Shader::CreateShader(const std::string& source, ShaderType shader_type) {
     const char* ShaderCode = source.c_str();
 
     // Compile these shaders.
@@ -110,17 +182,107 @@ GLboolean Shader::LinkShaderProgram(const GLuint& program_id) {
     return status;
 }
 
-GLuint Shader::GetUniformLocation(const std::string& uniform_name) {
-    if (m_uniform_location_cache.find(uniform_name) != m_uniform_location_cache.end()) {
-        return m_uniform_location_cache[uniform_name];
+// 字串版本的慢速路徑：執行期才計算雜湊，之後與 UniformHandle 查同一張表
+GLint Shader::GetUniformLocation(const std::string& uniform_name) {
+    return GetUniformLocation(UniformHandle(uniform_name), uniform_name.c_str());
+}
+
+GLint Shader::GetUniformLocation(UniformHandle uniform, const char* uniform_name) {
+    auto it = std::lower_bound(m_uniform_locations.begin(), m_uniform_locations.end(), uniform.hash,
+        [](const std::pair<std::uint64_t, GLint>& entry, std::uint64_t hash) { return entry.first < hash; });
+    if (it != m_uniform_locations.end() && it->first == uniform.hash) {
+        return it->second;
+    }
+
+    // 不存在的 uniform 只警告一次，之後以 -1 快取（glUniform* 會忽略 location -1）
+    std::cerr << "The uniform variable <" << (uniform_name ? uniform_name : std::to_string(uniform.hash))
+              << "> doesn't exist in this shader ID: " << std::to_string(m_id) << std::endl;
+    m_uniform_locations.insert(it, { uniform.hash, -1 });
+    return -1;
+}
+
+// link 之後一次查出所有 uniform 的 location（uniform block 的成員沒有 location，不列入）
+void Shader::ReflectUniforms() {
+    GLint uniform_count = 0;
+    GLint max_length = 0;
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &uniform_count);
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+    std::string name(static_cast<std::size_t>(std::max(max_length, 1)), '\0');
+    for (GLint i = 0; i < uniform_count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_id, static_cast<GLuint>(i), max_length, &length, &size, &type, name.data());
+
+        std::string_view uniform_name(name.data(), static_cast<std::size_t>(length));
+        GLint location = glGetUniformLocation(m_id, name.c_str());
+        if (location == -1) {
+            continue;
+        }
+        m_uniform_locations.emplace_back(hash::Fnv1a(uniform_name), location);
+
+        // 陣列回報的名稱是 "name[0]"，也讓 "name" 可以找到同一個 location
+        if (uniform_name.size() > 3 && uniform_name.substr(uniform_name.size() - 3) == "[0]") {
+            m_uniform_locations.emplace_back(hash::Fnv1a(uniform_name.substr(0, uniform_name.size() - 3)), location);
+        }
     }
 
-    GLuint location = glGetUniformLocation(m_id, uniform_name.c_str());
-    if (location == -1) {
-        std::cerr << "The uniform variable <" << uniform_name
-                  << "> doesn't exist in this shader ID: " << std::to_string(m_id) << std::endl;
+    std::sort(m_uniform_locations.begin(), m_uniform_locations.end());
+    auto duplicate = std::adjacent_find(m_uniform_locations.begin(), m_uniform_locations.end(),
+        [](const auto& a, const auto& b) { return a.first == b.first; });
+    if (duplicate != m_uniform_locations.end()) {
+        std::cerr << "[Warning] Two uniforms in shader ID " << m_id << " have the same name hash" << std::endl;
     }
+}
+
+
+// 查詢每個 uniform block 的大小與成員的 offset，UniformBuffer 依此寫入資料，不必在 C++ 端手動對齊 std140
+void Shader::ReflectUniformBlocks() {
+    GLint block_count = 0;
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCKS, &block_count);
+
+    for (GLint block = 0; block < block_count; ++block) {
+        UniformBlockLayout layout;
+        layout.index = static_cast<GLuint>(block);
+
+        GLint name_length = 0;
+        glGetActiveUniformBlockiv(m_id, layout.index, GL_UNIFORM_BLOCK_NAME_LENGTH, &name_length);
+        layout.name.resize(name_length);
+        glGetActiveUniformBlockName(m_id, layout.index, name_length, &name_length, layout.name.data());
+        layout.name.resize(name_length);
+        glGetActiveUniformBlockiv(m_id, layout.index, GL_UNIFORM_BLOCK_DATA_SIZE, &layout.size);
 
-    m_uniform_location_cache[uniform_name] = location;
-    return location;
+        GLint member_count = 0;
+        glGetActiveUniformBlockiv(m_id, layout.index, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &member_count);
+        std::vector<GLint> indices(member_count);
+        glGetActiveUniformBlockiv(m_id, layout.index, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data());
+        std::vector<GLuint> members(indices.begin(), indices.end());
+
+        std::vector<GLint> offsets(member_count), array_strides(member_count), matrix_strides(member_count), types(member_count);
+        glGetActiveUniformsiv(m_id, member_count, members.data(), GL_UNIFORM_OFFSET, offsets.data());
+        glGetActiveUniformsiv(m_id, member_count, members.data(), GL_UNIFORM_ARRAY_STRIDE, array_strides.data());
+        glGetActiveUniformsiv(m_id, member_count, members.data(), GL_UNIFORM_MATRIX_STRIDE, matrix_strides.data());
+        glGetActiveUniformsiv(m_id, member_count, members.data(), GL_UNIFORM_TYPE, types.data());
+
+        for (GLint i = 0; i < member_count; ++i) {
+            GLint length = 0;
+            glGetActiveUniformsiv(m_id, 1, &members[i], GL_UNIFORM_NAME_LENGTH, &length);
+            std::string name(length, '\0');
+            glGetActiveUniformName(m_id, members[i], length, &length, name.data());
+            name.resize(length);
+
+            // 陣列成員回報的名稱是 "name[0]"，帶有 instance name 的 block 則是 "Block.name"
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+                name.resize(name.size() - 3);
+            }
+            if (name.compare(0, layout.name.size() + 1, layout.name + ".") == 0) {
+                name.erase(0, layout.name.size() + 1);
+            }
+
+            layout.members[name] = { offsets[i], array_strides[i], matrix_strides[i], static_cast<GLenum>(types[i]) };
+        }
+
+        m_uniform_blocks[layout.name] = std::move(layout);
+    }
 }
\ No newline at end of file
@@ -1,45 +1,183 @@
 #include "Texture.hpp"
 
-Texture::Texture(const std::string &filename) : id(0) {
+#include "BlockCompression.hpp"
+#include "GLFeatures.hpp"
+#include "ImageCache.hpp"
+#include "PixelUploader.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+
+static bool GetPixelFormat(int channels, GLenum& internal_format, GLenum& format) {
+    switch (channels) {
+        case 1:
+            internal_format = GL_R8;
+            format = GL_RED;
+            return true;
+        case 3:
+            internal_format = GL_RGB8;
+            format = GL_RGB;
+            return true;
+        case 4:
+            internal_format = GL_RGBA8;
+            format = GL_RGBA;
+            return true;
+        default:
+            std::cout << "The Images File format is not supported yet!"  << std::endl;
+            return false;
+    }
+}
+
+// 一次配置好 levels 層的空間。immutable storage 的大小與層數之後不能再改，driver 不必在每次 Bind 時重新檢查 mip chain 是否完整；
+// 關掉或 context 不支援時退回逐層 glTexImage*，並以 MAX_LEVEL 把層數限制在 levels 之內
+static void AllocateStorage(GLenum target, GLsizei levels, GLenum internal_format, GLenum format, GLsizei width, GLsizei height, GLsizei layers, bool immutable) {
+    if (immutable && gl_features::TextureStorage()) {
+        if (target == GL_TEXTURE_2D_ARRAY) {
+            glTexStorage3D(target, levels, internal_format, width, height, layers);
+        } else {
+            glTexStorage2D(target, levels, internal_format, width, height);
+        }
+        return;
+    }
+
+    for (GLint level = 0; level < levels; ++level) {
+        if (target == GL_TEXTURE_2D_ARRAY) {
+            glTexImage3D(target, level, internal_format, width, height, layers, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        } else {
+            glTexImage2D(target, level, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        }
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levels - 1);
+}
+
+// RGB 或縮小後的奇數寬度每列不一定是 4 的倍數，維持預設的 4 會讀到下一列的像素，畫面就會歪掉
+void SetUnpackAlignment(GLsizei width, int channels) {
+    std::size_t row = static_cast<std::size_t>(width) * channels;
+    GLint alignment = row % 8 == 0 ? 8 : row % 4 == 0 ? 4 : row % 2 == 0 ? 2 : 1;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+// 依序上傳每一層；target 為 GL_TEXTURE_2D_ARRAY 時每層包含所有 layer
+static std::size_t UploadCompressed(GLenum target, const CompressedImage& image, bool immutable) {
+    if (!image.IsValid()) {
+        std::cout << "Failed to load texture" << std::endl;
+        exit(-42069);
+    }
+
+    const GLsizei depth = std::max(1, image.layers);
+    const GLsizei levels = static_cast<GLsizei>(image.levels.size());
+    const CompressedImage::Level& base = image.levels[0];
+    std::size_t bytes = 0;
+    if (gl_features::CompressedFormat(image.internal_format)) {
+        bool storage = immutable && gl_features::TextureStorage();
+        if (storage && target == GL_TEXTURE_2D_ARRAY) {
+            glTexStorage3D(target, levels, image.internal_format, base.width, base.height, depth);
+        } else if (storage) {
+            glTexStorage2D(target, levels, image.internal_format, base.width, base.height);
+        }
+        for (std::size_t i = 0; i < image.levels.size(); ++i) {
+            const CompressedImage::Level& level = image.levels[i];
+            GLint mip = static_cast<GLint>(i);
+            GLsizei size = static_cast<GLsizei>(level.size);
+            bytes += level.size;
+            if (storage && target == GL_TEXTURE_2D_ARRAY) {
+                glCompressedTexSubImage3D(target, mip, 0, 0, 0, level.width, level.height, depth, image.internal_format, size, level.data.get());
+            } else if (storage) {
+                glCompressedTexSubImage2D(target, mip, 0, 0, level.width, level.height, image.internal_format, size, level.data.get());
+            } else if (target == GL_TEXTURE_2D_ARRAY) {
+                glCompressedTexImage3D(target, mip, image.internal_format, level.width, level.height, depth, 0, size, level.data.get());
+            } else {
+                glCompressedTexImage2D(target, mip, image.internal_format, level.width, level.height, 0, size, level.data.get());
+            }
+        }
+    } else if (image.internal_format == compressed_format::Bc1 || image.internal_format == compressed_format::Bc3) {
+        // 沒有 S3TC 的 context：解壓縮回 RGBA8，至少畫面是對的
+        bcn::Format format = image.internal_format == compressed_format::Bc1 ? bcn::Format::Bc1 : bcn::Format::Bc3;
+        AllocateStorage(target, levels, GL_RGBA8, GL_RGBA, base.width, base.height, depth, immutable);
+        std::vector<unsigned char> pixels;
+        for (std::size_t i = 0; i < image.levels.size(); ++i) {
+            const CompressedImage::Level& level = image.levels[i];
+            std::size_t layer_pixels = static_cast<std::size_t>(level.width) * level.height * 4;
+            std::size_t layer_blocks = bcn::CompressedSize(format, level.width, level.height);
+            pixels.resize(layer_pixels * depth);
+            bytes += pixels.size();
+            for (GLsizei layer = 0; layer < depth; ++layer) {
+                bcn::Decode(format, level.data.get() + layer_blocks * layer, level.width, level.height, pixels.data() + layer_pixels * layer);
+            }
+            GLint mip = static_cast<GLint>(i);
+            if (target == GL_TEXTURE_2D_ARRAY) {
+                glTexSubImage3D(target, mip, 0, 0, 0, level.width, level.height, depth, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            } else {
+                glTexSubImage2D(target, mip, 0, 0, level.width, level.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            }
+        }
+    } else {
+        std::cout << "The compressed texture format 0x" << std::hex << image.internal_format << std::dec
+                  << " is not supported by this OpenGL context!" << std::endl;
+        exit(-42069);
+    }
+    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    return bytes;
+}
+
+Texture::Texture(const std::string &filename, const TextureOptions &options) :
+    Texture(ImageCache::Default().Load(filename, options.mipmap_filter), options) {}
+
+Texture::Texture(const Image &image, const TextureOptions &options) : id(0), bytes(0) {
+    PROFILE_ZONE("Upload texture");
     glGenTextures(1, &id);
     glBindTexture(GL_TEXTURE_2D, id);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char *image = stbi_load(filename.c_str(), &width, &height, &nrChannels, 0);
-    if (image) {
+
+    if (image.IsValid()) {
         GLenum internal_format(-1);
         GLenum format(-1);
+        GetPixelFormat(image.channels, internal_format, format);
 
-        switch (nrChannels) {
-            case 1:
-                internal_format = GL_R8;
-                format = GL_RED;
-                break;
-            case 3:
-                internal_format = GL_RGB8;
-                format = GL_RGB;
-                break;
-            case 4:
-                internal_format = GL_RGBA8;
-                format = GL_RGBA;
-                break;
-            default:
-                std::cout << "The Images File format is not supported yet!"  << std::endl;
-                break;
-        }
-
-        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, image);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        // 先配置整條 mip chain 的空間，像素再經由 PixelUploader 的 PBO ring 以 glTexSubImage2D 上傳
+        PixelUploader& uploader = PixelUploader::Default();
+        if (options.mipmap_filter == MipmapFilter::Driver) {
+            // glGenerateMipmap 只需要填滿已經配置好的層，不必再重新配置
+            GLsizei levels = mipmap::LevelCount(image.width, image.height);
+            AllocateStorage(GL_TEXTURE_2D, levels, internal_format, format, image.width, image.height, 1, options.immutable_storage);
+            SetUnpackAlignment(image.width, image.channels);
+            uploader.Upload2D(GL_TEXTURE_2D, 0, image.width, image.height, format, GL_UNSIGNED_BYTE, image.pixels.get(), image.Size());
+            glGenerateMipmap(GL_TEXTURE_2D);
+            bytes = image.Size() + image.Size() / 3;
+        } else {
+            // 從快取來的圖片已經帶有 mip chain，否則就在這裡產生
+            Image source = image;
+            if (source.mipmaps.empty()) {
+                mipmap::Generate(source, options.mipmap_filter);
+            }
+
+            GLsizei levels = static_cast<GLsizei>(source.mipmaps.size()) + 1;
+            AllocateStorage(GL_TEXTURE_2D, levels, internal_format, format, source.width, source.height, 1, options.immutable_storage);
+            SetUnpackAlignment(source.width, source.channels);
+            uploader.Upload2D(GL_TEXTURE_2D, 0, source.width, source.height, format, GL_UNSIGNED_BYTE, source.pixels.get(), source.Size());
+            bytes = source.Size();
+            for (std::size_t i = 0; i < source.mipmaps.size(); ++i) {
+                const Image::MipLevel& level = source.mipmaps[i];
+                GLint mip = static_cast<GLint>(i + 1);
+                std::size_t level_size = static_cast<std::size_t>(level.width) * level.height * source.channels;
+                SetUnpackAlignment(level.width, source.channels);
+                uploader.Upload2D(GL_TEXTURE_2D, mip, level.width, level.height, format, GL_UNSIGNED_BYTE, level.pixels.get(), level_size);
+                bytes += level_size;
+            }
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     } else {
         std::cout << "Failed to load texture" << std::endl;
         exit(-42069);
     }
-    stbi_image_free(image);
+}
+
+Texture::Texture(const CompressedImage& image, const TextureOptions& options) : id(0), bytes(0) {
+    PROFILE_ZONE("Upload compressed texture");
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    bytes = UploadCompressed(GL_TEXTURE_2D, image, options.immutable_storage);
 }
 
 Texture::~Texture() {
@@ -48,4 +186,83 @@ Texture::~Texture() {
 
 void Texture::Bind() {
     glBindTexture(GL_TEXTURE_2D, id);
+}
+
+TextureArray::TextureArray(const std::vector<Image>& images, const TextureOptions& options) :
+    id(0),
+    layers(static_cast<int>(images.size())) {
+    if (images.empty() || !images[0].IsValid()) {
+        std::cout << "Failed to load texture" << std::endl;
+        exit(-42069);
+    }
+
+    // 所有影格必須有相同的大小與通道數，才能放進同一個 array 中
+    const Image& first = images[0];
+    for (const auto& image : images) {
+        if (!image.IsValid()) {
+            std::cout << "Failed to load texture" << std::endl;
+            exit(-42069);
+        }
+        if (image.width != first.width || image.height != first.height || image.channels != first.channels) {
+            std::cout << "All layers of a texture array must have the same size and format!" << std::endl;
+            exit(-42069);
+        }
+    }
+
+    PROFILE_ZONE("Upload texture array");
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+
+    GLenum internal_format(-1);
+    GLenum format(-1);
+    GetPixelFormat(first.channels, internal_format, format);
+
+    PixelUploader& uploader = PixelUploader::Default();
+    GLsizei levels = mipmap::LevelCount(first.width, first.height);
+    AllocateStorage(GL_TEXTURE_2D_ARRAY, levels, internal_format, format, first.width, first.height, layers, options.immutable_storage);
+    if (options.mipmap_filter == MipmapFilter::Driver) {
+        SetUnpackAlignment(first.width, first.channels);
+        for (int layer = 0; layer < layers; ++layer) {
+            uploader.Upload3D(GL_TEXTURE_2D_ARRAY, 0, layer, first.width, first.height, format, GL_UNSIGNED_BYTE, images[layer].pixels.get(),
+                images[layer].Size());
+        }
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        return;
+    }
+
+    // 從快取來的圖片已經帶有 mip chain，否則就在這裡產生
+    std::vector<Image> sources(images.begin(), images.end());
+    for (auto& source : sources) {
+        if (source.mipmaps.empty()) {
+            mipmap::Generate(source, options.mipmap_filter);
+        }
+    }
+
+    for (GLint level = 0; level < levels; ++level) {
+        int width = level == 0 ? first.width : sources[0].mipmaps[level - 1].width;
+        int height = level == 0 ? first.height : sources[0].mipmaps[level - 1].height;
+        SetUnpackAlignment(width, first.channels);
+        for (int layer = 0; layer < layers; ++layer) {
+            const unsigned char* pixels = level == 0 ? sources[layer].pixels.get() : sources[layer].mipmaps[level - 1].pixels.get();
+            uploader.Upload3D(GL_TEXTURE_2D_ARRAY, level, layer, width, height, format, GL_UNSIGNED_BYTE, pixels,
+                static_cast<std::size_t>(width) * height * first.channels);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+TextureArray::TextureArray(const CompressedImage& image, const TextureOptions& options) : id(0), layers(std::max(1, image.layers)) {
+    PROFILE_ZONE("Upload compressed texture array");
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+    UploadCompressed(GL_TEXTURE_2D_ARRAY, image, options.immutable_storage);
+}
+
+TextureArray::~TextureArray() {
+    glDeleteTextures(1, &id);
+}
+
+void TextureArray::Bind() {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "TextureCache.hpp"
+#include "ImageCache.hpp"
+
+#include <filesystem>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+TextureCache& TextureCache::Default() {
+    static TextureCache cache;
+    return cache;
+}
+
+// 以絕對路徑去掉 "./"、".." 與 symlink 的差異，不存在的檔案則保留原本的寫法。
+// weakly_canonical 每次都要 stat 路徑上的每一層，結果依原本的字串記下來，之後的 Load / Find 只剩一次查表
+const std::string& TextureCache::CanonicalPath(const std::string& filename) {
+    auto it = m_canonical.find(filename);
+    if (it != m_canonical.end()) {
+        return it->second;
+    }
+
+    std::error_code error;
+    fs::path path = fs::weakly_canonical(fs::path(filename), error);
+    return m_canonical.emplace(filename, error ? filename : path.string()).first->second;
+}
+
+// TextureOptions 的每個欄位都會影響建立出來的貼圖，新增欄位時也要加進 key
+std::string TextureCache::Key(const std::string& filename, const TextureOptions& options) {
+    return CanonicalPath(filename) + '|' + std::to_string(static_cast<int>(options.mipmap_filter)) + '|' + (options.immutable_storage ? '1' : '0');
+}
+
+std::shared_ptr<Texture> TextureCache::Load(const std::string& filename, const TextureOptions& options) {
+    std::string key = Key(filename, options);
+    if (std::shared_ptr<Texture> texture = m_textures[key].lock()) {
+        ++hits;
+        return texture;
+    }
+
+    ++misses;
+    EraseExpired();
+    auto texture = std::make_shared<Texture>(ImageCache::Default().Load(filename, options.mipmap_filter), options);
+    m_textures[key] = texture;
+    return texture;
+}
+
+std::shared_ptr<Texture> TextureCache::Find(const std::string& filename, const TextureOptions& options) {
+    auto it = m_textures.find(Key(filename, options));
+    return it == m_textures.end() ? nullptr : it->second.lock();
+}
+
+std::shared_ptr<Texture> TextureCache::Insert(const std::string& filename, const TextureOptions& options, const Image& image) {
+    std::string key = Key(filename, options);
+    if (std::shared_ptr<Texture> texture = m_textures[key].lock()) {
+        ++hits;
+        return texture;
+    }
+
+    ++misses;
+    EraseExpired();
+    auto texture = std::make_shared<Texture>(image, options);
+    m_textures[key] = texture;
+    return texture;
+}
+
+std::size_t TextureCache::Size() {
+    EraseExpired();
+    return m_textures.size();
+}
+
+std::size_t TextureCache::ResidentBytes() const {
+    std::size_t bytes = 0;
+    for (const auto& entry : m_textures) {
+        if (std::shared_ptr<Texture> texture = entry.second.lock()) {
+            bytes += texture->bytes;
+        }
+    }
+    return bytes;
+}
+
+// 最後一個 handle 放開之後 weak_ptr 還留在表裡，不清掉的話長時間串流不同的貼圖會讓表一直變大
+void TextureCache::EraseExpired() {
+    for (auto it = m_textures.begin(); it != m_textures.end();) {
+        if (it->second.expired()) {
+            it = m_textures.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
\ No newline at end of file
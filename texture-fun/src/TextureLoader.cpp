@@ -0,0 +1,40 @@
+#include "TextureLoader.hpp"
+
+TextureLoader::TextureLoader(ThreadPool& pool, ImageCache& cache) :
+    m_pool(pool),
+    m_cache(cache),
+    m_next_ticket(0),
+    m_pending(0) {}
+
+TextureLoader::~TextureLoader() {
+    // worker 的工作會參考到 this，所以必須等它們全部結束
+    m_pool.Wait();
+}
+
+std::size_t TextureLoader::Enqueue(const std::string& filename, MipmapFilter filter) {
+    std::size_t ticket = m_next_ticket++;
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+
+    // CPU mipmap 也在 worker 上產生，主執行緒只負責上傳
+    m_pool.Submit([this, ticket, filename, filter] {
+        Result result;
+        result.ticket = ticket;
+        result.filename = filename;
+        result.image = m_cache.Load(filename, filter);
+        m_completed.Push(std::move(result));
+    });
+
+    return ticket;
+}
+
+bool TextureLoader::Poll(Result& result) {
+    if (!m_completed.TryPop(result)) {
+        return false;
+    }
+    m_pending.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::size_t TextureLoader::Pending() const {
+    return m_pending.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,156 @@
+#include "TextureResidency.hpp"
+#include "Profiler.hpp"
+#include "TextureCache.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+TextureResidency::TextureResidency(ThreadPool& pool, std::size_t budget_bytes, const TextureOptions& options) :
+    m_loader(pool),
+    m_options(options),
+    m_budget(budget_bytes),
+    m_resident_bytes(0),
+    m_frame(1),
+    m_placeholder(0) {
+    // 1x1 的灰色貼圖，載入中的貼圖先以它代替；只有一層，所以 MAX_LEVEL 設為 0 才能搭配 mipmap 的 sampler
+    const unsigned char gray[4] = { 128, 128, 128, 255 };
+    glGenTextures(1, &m_placeholder);
+    glBindTexture(GL_TEXTURE_2D, m_placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gray);
+}
+
+TextureResidency::~TextureResidency() {
+    glDeleteTextures(1, &m_placeholder);
+}
+
+TextureResidency::Handle TextureResidency::Add(const std::string& filename) {
+    Entry entry;
+    entry.filename = filename;
+    m_entries.push_back(std::move(entry));
+    return m_entries.size() - 1;
+}
+
+GLuint TextureResidency::Acquire(Handle handle) {
+    Entry& entry = m_entries[handle];
+    entry.last_used = m_frame;
+    if (entry.texture) {
+        return entry.texture->id;
+    }
+
+    Prefetch(handle);
+    if (entry.texture) {
+        return entry.texture->id;
+    }
+    ++m_stats.misses;
+    return m_placeholder;
+}
+
+void TextureResidency::Prefetch(Handle handle) {
+    Entry& entry = m_entries[handle];
+    if (entry.texture || entry.loading || entry.failed) {
+        return;
+    }
+    // 還有別人持有同一張貼圖時不必重新載入
+    if (std::shared_ptr<Texture> texture = TextureCache::Default().Find(entry.filename, m_options)) {
+        MakeResident(entry, std::move(texture));
+        return;
+    }
+    entry.loading = true;
+    m_tickets[m_loader.Enqueue(entry.filename, m_options.mipmap_filter)] = handle;
+}
+
+bool TextureResidency::IsResident(Handle handle) const {
+    return m_entries[handle].texture != nullptr;
+}
+
+void TextureResidency::Update() {
+    PROFILE_ZONE("Texture residency");
+    TextureLoader::Result result;
+    while (m_loader.Poll(result)) {
+        Upload(result);
+    }
+    Evict();
+    ++m_frame;
+}
+
+void TextureResidency::Finish() {
+    TextureLoader::Result result;
+    while (m_loader.Pending() > 0) {
+        if (m_loader.Poll(result)) {
+            Upload(result);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TextureResidency::SetBudget(std::size_t budget_bytes) {
+    m_budget = budget_bytes;
+}
+
+std::size_t TextureResidency::Budget() const {
+    return m_budget;
+}
+
+std::size_t TextureResidency::ResidentBytes() const {
+    return m_resident_bytes;
+}
+
+const TextureResidency::Stats& TextureResidency::GetStats() const {
+    return m_stats;
+}
+
+void TextureResidency::Upload(TextureLoader::Result& result) {
+    auto ticket = m_tickets.find(result.ticket);
+    if (ticket == m_tickets.end()) {
+        return;
+    }
+    Entry& entry = m_entries[ticket->second];
+    m_tickets.erase(ticket);
+    entry.loading = false;
+
+    if (!result.image.IsValid()) {
+        std::cout << "Failed to load texture: " << entry.filename << std::endl;
+        entry.failed = true;
+        return;
+    }
+
+    MakeResident(entry, TextureCache::Default().Insert(entry.filename, m_options, result.image));
+    ++m_stats.loads;
+}
+
+// 剛載入的貼圖當作這個 frame 用過，避免在被畫出來之前就又被刪掉
+void TextureResidency::MakeResident(Entry& entry, std::shared_ptr<Texture> texture) {
+    entry.texture = std::move(texture);
+    entry.last_used = std::max(entry.last_used, m_frame);
+    m_resident_bytes += entry.texture->bytes;
+}
+
+void TextureResidency::Evict() {
+    if (m_budget == 0 || m_resident_bytes <= m_budget) {
+        return;
+    }
+
+    // 由最久沒用過的開始刪，這個 frame 用過的不刪
+    std::vector<Handle> candidates;
+    for (Handle handle = 0; handle < m_entries.size(); ++handle) {
+        if (m_entries[handle].texture && m_entries[handle].last_used < m_frame) {
+            candidates.push_back(handle);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](Handle a, Handle b) {
+        return m_entries[a].last_used < m_entries[b].last_used;
+    });
+
+    for (Handle handle : candidates) {
+        if (m_resident_bytes <= m_budget) {
+            break;
+        }
+        Entry& entry = m_entries[handle];
+        m_resident_bytes -= entry.texture->bytes;
+        entry.texture.reset();
+        ++m_stats.evictions;
+    }
+}
@@ -0,0 +1,68 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int num_threads) : m_running(0), m_stopping(false) {
+    // hardware_concurrency() 在無法得知核心數時會回傳 0
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+
+    m_workers.reserve(num_threads);
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_job_available.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push(std::move(job));
+    }
+    m_job_available.notify_one();
+}
+
+void ThreadPool::Wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_all_done.wait(lock, [this] { return m_jobs.empty() && m_running == 0; });
+}
+
+unsigned int ThreadPool::Size() const {
+    return static_cast<unsigned int>(m_workers.size());
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_job_available.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_jobs.empty()) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+            ++m_running;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_running;
+            if (m_jobs.empty() && m_running == 0) {
+                m_all_done.notify_all();
+            }
+        }
+    }
+}
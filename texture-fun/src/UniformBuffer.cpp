@@ -0,0 +1,81 @@
+#include "UniformBuffer.hpp"
+
+#include "Profiler.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+#include <iostream>
+
+const UniformBlockLayout::Member* UniformBlockLayout::Find(const std::string& member_name) const {
+    auto it = members.find(member_name);
+    return it == members.end() ? nullptr : &it->second;
+}
+
+UniformBuffer::UniformBuffer(GLuint binding, const UniformBlockLayout& layout) :
+    m_id(0),
+    m_binding(binding),
+    m_layout(layout),
+    m_data(static_cast<std::size_t>(layout.size), 0),
+    m_dirty(true) {
+    glGenBuffers(1, &m_id);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(m_data.size()), m_data.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_id);
+}
+
+UniformBuffer::~UniformBuffer() {
+    glDeleteBuffers(1, &m_id);
+}
+
+unsigned char* UniformBuffer::MemberData(const std::string& member_name, GLenum type) {
+    const UniformBlockLayout::Member* member = m_layout.Find(member_name);
+    if (member == nullptr || member->type != type) {
+        std::cerr << "The uniform block <" << m_layout.name << "> has no member <" << member_name << "> of this type" << std::endl;
+        return nullptr;
+    }
+    m_dirty = true;
+    return m_data.data() + member->offset;
+}
+
+void UniformBuffer::SetInt(const std::string& member_name, int value) {
+    if (unsigned char* data = MemberData(member_name, GL_INT)) {
+        std::memcpy(data, &value, sizeof(value));
+    }
+}
+
+void UniformBuffer::SetFloat(const std::string& member_name, float value) {
+    if (unsigned char* data = MemberData(member_name, GL_FLOAT)) {
+        std::memcpy(data, &value, sizeof(value));
+    }
+}
+
+void UniformBuffer::SetVec4(const std::string& member_name, const glm::vec4& vector) {
+    if (unsigned char* data = MemberData(member_name, GL_FLOAT_VEC4)) {
+        std::memcpy(data, glm::value_ptr(vector), sizeof(float) * 4);
+    }
+}
+
+void UniformBuffer::SetMat4(const std::string& member_name, const glm::mat4& matrix) {
+    const UniformBlockLayout::Member* member = m_layout.Find(member_name);
+    unsigned char* data = MemberData(member_name, GL_FLOAT_MAT4);
+    if (data == nullptr) {
+        return;
+    }
+    // std140 的 column-major mat4 每一欄間隔 matrix_stride（一般就是 16 bytes，與 glm 相同）
+    for (int column = 0; column < 4; ++column) {
+        std::memcpy(data + column * member->matrix_stride, glm::value_ptr(matrix) + column * 4, sizeof(float) * 4);
+    }
+}
+
+void UniformBuffer::Upload() {
+    if (!m_dirty) {
+        return;
+    }
+    PROFILE_ZONE("Upload uniforms");
+    glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(m_data.size()), m_data.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    m_dirty = false;
+}
@@ -3,44 +3,155 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#ifdef TEXTURE_FUN_PROFILER_OVERLAY
+#include <imgui.h>
+#include <imgui_impl_opengl3.h>
+#include <imgui_impl_sdl2.h>
+#endif
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "AnimatedTexture.hpp"
+#include "Benchmark.hpp"
+#include "CompressedImage.hpp"
+#include "FixedTimestep.hpp"
+#include "GpuTimer.hpp"
 #include "MatrixStack.hpp"
+#include "OffscreenTarget.hpp"
+#include "PixelUploader.hpp"
+#include "Profiler.hpp"
+#include "QuadRenderer.hpp"
+#include "ProgramCache.hpp"
+#include "Sampler.hpp"
+#include "SceneGraph.hpp"
 #include "Shader.hpp"
 #include "Texture.hpp"
+#include "TextureCache.hpp"
 #include "Camera.hpp"
+#include "TextureResidency.hpp"
+#include "UniformBuffer.hpp"
 
 static unsigned int window_width = 800;
 static unsigned int window_height = 600;
 
-static std::vector<float> vertices = {
-    // Position             // Texture
-    -0.5f, -0.5f, 0.0f,     0.0f, 0.0f,
-     0.5f, -0.5f, 0.0f,     1.0f, 0.0f,
-     0.5f,  0.5f, 0.0f,     1.0f, 1.0f,
-    -0.5f,  0.5f, 0.0f,     0.0f, 1.0f,
-};
-
-static std::vector<unsigned int> indices = {
-    0, 1, 2,
-    0, 2, 3,
-};
-
 std::unique_ptr<Shader> my_shader = nullptr;
-std::unique_ptr<MatrixStack> model = nullptr;
 std::unique_ptr<Camera> my_camera = nullptr;
+std::unique_ptr<UniformBuffer> camera_ubo = nullptr;
+std::unique_ptr<QuadRenderer> quads = nullptr;
 
-static int keyFrameRate = 15.0;
+// current_time 是畫面呈現的模擬時間（已內插），delta_time 是這個 frame 經過的實際時間
 float current_time = 0.0f;
 float delta_time = 0.0f;
-float last_time = 0.0f;
+
+// start_times[i] 為第 i 張影格開始的時間，最後一個元素為整段動畫的長度（毫秒），超過總長度時循環播放
+static float FlipbookLayer(const std::vector<long long>& start_times, float time) {
+    long long ms = static_cast<long long>(std::max(time, 0.0f) * 1000.0f) % std::max(1LL, start_times.back());
+    auto it = std::upper_bound(start_times.begin(), start_times.end(), ms);
+    return static_cast<float>(it - start_times.begin() - 1);
+}
 
 int main(int argc, char **argv) {
+    // --no-upload-ring：不經過 PBO ring，直接從 client memory 上傳（用來比較 frame time）
+    // --quads N：額外畫 N 個四邊形（排成一面會旋轉的牆），用來觀察 instancing 與場景樹更新的 CPU 成本
+    // --headless：隱藏視窗、關閉 vsync 與音效，畫在 FBO 上，並以固定的 1/60 秒推進時間（預設只跑 1 個 frame）
+    // --frames N：跑 N 個 frame 之後結束；--dump DIR：把畫面存成 DIR/frame_NNNNN.ppm；--dump-every N：每 N 個 frame 存一張
+    // --benchmark FILE：headless 並以固定的相機路徑跑 600 個 frame（可用 --frames 修改），CPU / GPU 時間統計寫成 JSON
+    // --baseline FILE：與之前的 JSON 報告比較，p95 慢了超過 --threshold（預設 0.1，即 10%）時以非零值結束
+    // --tick-rate HZ：模擬的固定步長（預設 60Hz）；--fps-limit N：關掉 vsync，最多每秒畫 N 個 frame（0 表示不限制）
+    // --profile：記錄 CPU / GPU zone，結束時印出每個 frame 的平均時間；--trace FILE：另外輸出 Chrome trace JSON
+    // --texture-budget MB：貼圖最多佔用的 VRAM（預設 256MB，0 表示不限制），超過時刪掉最久沒用到的貼圖，用到時再從磁碟快取載入
+    // --anisotropy N：地板使用的 anisotropic filtering 倍數（預設 16，會夾到 driver 支援的最大值，1 表示關閉）
+    // --compressed：改用 texture-compress 產生的 KTX（BC1 / BC3），GIF 的影格整組放在一個 2D array 中，以 layer 切換
+    // --texture-array：不串流播放 GIF，載入時把所有影格解碼進一個 2D array（不需要先跑 texture-compress）
+    // --mutable-textures：不用 glTexStorage，改回逐層 glTexImage 配置貼圖（用來比較上傳與 Bind 的成本）
+    int extra_quads = 0;
+    bool headless = false;
+    int max_frames = 0;
+    std::string dump_directory;
+    int dump_every = 1;
+    std::string benchmark_report;
+    std::string benchmark_baseline;
+    float benchmark_threshold = 0.1f;
+    double tick_rate = 60.0;
+    int fps_limit = -1;
+    bool profiling = false;
+    std::string trace_file;
+    bool compressed = false;
+    bool texture_array = false;
+    bool mutable_textures = false;
+    std::size_t texture_budget_mb = 256;
+    float anisotropy = 16.0f;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-upload-ring") == 0) {
+            PixelUploader::Default().enabled = false;
+        } else if (std::strcmp(argv[i], "--quads") == 0 && i + 1 < argc) {
+            extra_quads = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            max_frames = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dump_directory = argv[++i];
+        } else if (std::strcmp(argv[i], "--dump-every") == 0 && i + 1 < argc) {
+            dump_every = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) {
+            benchmark_report = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            benchmark_baseline = argv[++i];
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            benchmark_threshold = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tick_rate = std::max(1.0, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--fps-limit") == 0 && i + 1 < argc) {
+            fps_limit = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--profile") == 0) {
+            profiling = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_file = argv[++i];
+            profiling = true;
+        } else if (std::strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc) {
+            texture_budget_mb = static_cast<std::size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--anisotropy") == 0 && i + 1 < argc) {
+            anisotropy = static_cast<float>(std::max(1.0, std::atof(argv[++i])));
+        } else if (std::strcmp(argv[i], "--compressed") == 0) {
+            compressed = true;
+        } else if (std::strcmp(argv[i], "--texture-array") == 0) {
+            texture_array = true;
+        } else if (std::strcmp(argv[i], "--mutable-textures") == 0) {
+            mutable_textures = true;
+        }
+    }
+    bool benchmarking = !benchmark_report.empty();
+    if (benchmarking) {
+        headless = true;
+        if (max_frames == 0) {
+            max_frames = 600;
+        }
+    }
+    if (headless && max_frames == 0) {
+        max_frames = 1;
+    }
+
+#ifdef TEXTURE_FUN_PROFILER_OVERLAY
+    // 有 overlay 的版本只要開了視窗就會記錄
+    bool show_overlay = !headless;
+    profiling = profiling || show_overlay;
+#endif
+    // 在載入貼圖之前開啟，背景解碼與上傳也會被記錄下來
+    profiler::SetEnabled(profiling);
+    profiler::SetThreadName("Main");
 
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
+    if (SDL_Init(SDL_INIT_VIDEO | (headless ? 0 : SDL_INIT_AUDIO)) != 0) {
         std::cout << "SDL_Init Error: " << SDL_GetError() << std::endl;
         return -1;
     }
@@ -59,7 +170,8 @@ int main(int argc, char **argv) {
     SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
     SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
 
-    const auto flags = SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI;
+    const auto flags = SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI |
+                       (headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
     SDL_Window *window = SDL_CreateWindow("Texture Example: SDL2 with stb_image", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, window_width, window_height, flags);
     if (window == nullptr) {
         std::cout << "SDL_CreateWindow Error: " << SDL_GetError() << std::endl;
@@ -70,7 +182,7 @@ int main(int argc, char **argv) {
     SDL_SetWindowMinimumSize(window, 400, 300);
     auto glContext = SDL_GL_CreateContext(window);
     SDL_GL_MakeCurrent(window, glContext);
-    SDL_GL_SetSwapInterval(1);
+    SDL_GL_SetSwapInterval(headless || fps_limit >= 0 ? 0 : 1);
 
     gladLoadGLLoader(SDL_GL_GetProcAddress);
 
@@ -79,138 +191,471 @@ int main(int argc, char **argv) {
               << "Renderer:              " << glGetString(GL_RENDERER) << "\n"
               << "Vendor:                " << glGetString(GL_VENDOR) << std::endl;
 
-    my_shader = std::make_unique<Shader>("assets/shaders/default.vert", "assets/shaders/default.frag");
+#ifdef TEXTURE_FUN_PROFILER_OVERLAY
+    if (show_overlay) {
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGui_ImplSDL2_InitForOpenGL(window, glContext);
+        ImGui_ImplOpenGL3_Init("#version 330 core");
+    }
+#endif
 
-    // 建立 Model Matrix Stack
-    model = std::make_unique<MatrixStack>();
+    auto shader_start = std::chrono::steady_clock::now();
+    my_shader = std::make_unique<Shader>("assets/shaders/instanced.vert", "assets/shaders/default.frag");
+    auto shader_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shader_start);
+    std::cout << "Shaders ready in " << shader_time.count() << " ms (" << ProgramCache::Default().hits << " from program cache, "
+              << ProgramCache::Default().misses << " compiled)" << std::endl;
+    my_shader->BindUniformBlock("Camera", UniformBinding::CameraBlock);
+    my_shader->Use();
+    my_shader->SetInt("ourTexture"_uniform, 0);
+
+    // 相機的矩陣每個 frame 只上傳一次；所有四邊形的 model matrix 由 QuadRenderer 收集起來以 instancing 一次畫完
+    camera_ubo = std::make_unique<UniformBuffer>(UniformBinding::CameraBlock, *my_shader->GetUniformBlock("Camera"));
+    quads = std::make_unique<QuadRenderer>();
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
 
     my_camera = std::make_unique<Camera>(glm::vec3(0.0f, 0.0f, 20.0f), glm::vec3(0.0f, 8.0f, 0.0f), true);
     my_camera->FollowTarget = false;
+    my_camera->viewport = {0, 0, static_cast<int>(window_width), static_cast<int>(window_height)};
 
-    GLuint vao;
-    GLuint vbo;
-    GLuint ebo;
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<const void *>(0));
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<const void *>(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    std::unique_ptr<OffscreenTarget> offscreen_target = nullptr;
+    if (headless) {
+        offscreen_target = std::make_unique<OffscreenTarget>(window_width, window_height);
+        offscreen_target->Bind();
+    }
 
-    std::vector<std::unique_ptr<Texture>> rickroll;
-    for (int i = 0; i < 28; ++i) {
-        rickroll.emplace_back(std::make_unique<Texture>("assets/textures/rickroll/rickroll (" + std::to_string(i + 1) + ").png"));
+    // 圖片在 streaming_pool 上解碼，主執行緒只負責把解碼好的像素上傳到 GPU；
+    // thread_pool 給 SceneGraph::Update 平行計算 world matrix
+    auto load_start = std::chrono::steady_clock::now();
+    ThreadPool thread_pool;
+
+    // mip chain 在 worker 上以 sRGB-correct 的 box filter 產生，並且會跟著像素一起存進快取
+    TextureOptions texture_options;
+    texture_options.mipmap_filter = MipmapFilter::SrgbBox;
+    texture_options.immutable_storage = !mutable_textures;
+
+    // 一般的貼圖交給 TextureResidency 管理。SceneGraph::Update 會 Wait 整個 thread_pool，
+    // 所以背景重新載入用另一個 pool，才不會讓畫面卡在解碼上
+    ThreadPool streaming_pool(1);
+    TextureResidency residency(streaming_pool, texture_budget_mb << 20, texture_options);
+
+    // 壓縮過的貼圖已經帶有 mip chain，直接 mmap 上傳，不經過解碼與 PBO ring
+    std::unique_ptr<Texture> my_background = nullptr;
+    std::unique_ptr<TextureArray> rickroll_frames = nullptr;
+    std::unique_ptr<Shader> flipbook_shader = nullptr;
+    std::vector<long long> rickroll_start_times{ 0 };
+    if (compressed) {
+        CompressedImage background_image("assets/textures/background.ktx");
+        CompressedImage rickroll_image("assets/textures/rickroll/rickroll.ktx");
+        if (background_image.IsValid() && rickroll_image.IsValid() && rickroll_image.layers > 0) {
+            my_background = std::make_unique<Texture>(background_image, texture_options);
+            rickroll_frames = std::make_unique<TextureArray>(rickroll_image, texture_options);
+
+            std::stringstream delays(rickroll_image.metadata["frame_delays_ms"]);
+            std::string delay;
+            // 每個 layer 只需要一個延遲，metadata 裡多出來的數字忽略
+            while (static_cast<int>(rickroll_start_times.size()) <= rickroll_frames->layers && std::getline(delays, delay, ',')) {
+                rickroll_start_times.push_back(rickroll_start_times.back() + std::max(1, std::atoi(delay.c_str())));
+            }
+            while (static_cast<int>(rickroll_start_times.size()) <= rickroll_frames->layers) {
+                rickroll_start_times.push_back(rickroll_start_times.back() + 100);
+            }
+        } else {
+            std::cout << "Compressed textures not found, run texture-compress on assets/textures first" << std::endl;
+        }
+    }
+    if (texture_array && !rickroll_frames) {
+        std::vector<Image> frames;
+        std::vector<int> delays;
+        if (LoadGifFrames("assets/textures/rickroll/rickroll.gif", frames, delays)) {
+            rickroll_frames = std::make_unique<TextureArray>(frames, texture_options);
+            for (int delay : delays) {
+                rickroll_start_times.push_back(rickroll_start_times.back() + delay);
+            }
+        }
+    }
+    if (rickroll_frames) {
+        flipbook_shader = std::make_unique<Shader>("assets/shaders/instanced.vert", "assets/shaders/flipbook.frag");
+        flipbook_shader->BindUniformBlock("Camera", UniformBinding::CameraBlock);
+        flipbook_shader->Use();
+        flipbook_shader->SetInt("ourTextures"_uniform, 0);
     }
 
-    std::unique_ptr<Texture> my_background = std::make_unique<Texture>("assets/textures/background.png");
+    // 第一個 frame 之前就載入完成，畫面上不會出現 placeholder
+    TextureResidency::Handle background_handle = 0;
+    if (!my_background) {
+        background_handle = residency.Add("assets/textures/background.png");
+        residency.Prefetch(background_handle);
+        residency.Finish();
+    }
 
-    int mix_flags = MIX_INIT_MP3;
-    int initted = Mix_Init(flags);
-    if(initted & flags != flags) {
-        printf("Mix_Init: Failed to init required mp3 support!\n");
-        printf("Mix_Init: %s\n", Mix_GetError());
-        exit(1);
+    // 取樣方式跟貼圖分開：背景與地板是同一張貼圖，只有斜著看的地板需要 anisotropic filtering
+    SamplerCache samplers;
+    SamplerState trilinear;
+    SamplerState anisotropic;
+    anisotropic.anisotropy = anisotropy;
+    GLuint trilinear_sampler = samplers.Get(trilinear);
+    GLuint floor_sampler = samplers.Get(anisotropic);
+
+    // 影格數與播放速度直接從 GIF 讀取，影格在播放時才於 streaming_pool 上逐張解碼
+    std::unique_ptr<AnimatedTexture> rickroll = nullptr;
+    std::size_t rickroll_material = 0;
+    int rickroll_frame_count = 0;
+    float rickroll_duration = 0.0f;
+    if (rickroll_frames) {
+        rickroll_material = quads->AddMaterial(*flipbook_shader, GL_TEXTURE_2D_ARRAY, rickroll_frames->id, trilinear_sampler);
+        rickroll_frame_count = rickroll_frames->layers;
+        rickroll_duration = static_cast<float>(rickroll_start_times.back()) / 1000.0f;
+    } else {
+        rickroll = std::make_unique<AnimatedTexture>(streaming_pool, "assets/textures/rickroll/rickroll.gif", texture_options);
+        rickroll_material = quads->AddMaterial(*my_shader, GL_TEXTURE_2D, rickroll->id, trilinear_sampler);
+        rickroll_frame_count = rickroll->frames;
+        rickroll_duration = rickroll->Duration();
+    }
+    GLuint background_texture = my_background ? my_background->id : residency.Acquire(background_handle);
+    std::size_t background_material = quads->AddMaterial(*my_shader, GL_TEXTURE_2D, background_texture, trilinear_sampler);
+    std::size_t floor_material = quads->AddMaterial(*my_shader, GL_TEXTURE_2D, background_texture, floor_sampler);
+
+    auto load_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start);
+    std::cout << "Samplers:              " << samplers.Size() << " (max anisotropy " << samplers.MaxAnisotropy() << ")" << std::endl;
+    std::cout << "Loaded " << (my_background ? "compressed " : "") << "textures in " << load_time.count() << " ms using "
+              << streaming_pool.Size() << (streaming_pool.Size() == 1 ? " decode thread (" : " decode threads (")
+              << rickroll_frame_count << " animation frames, "
+              << rickroll_duration << " s)" << std::endl;
+
+    // 場景樹：rickroll、背景、地板與四邊形牆都掛在 root 底下，牆上的四邊形再掛在牆的節點底下，
+    // 每個 frame 只有 rickroll 與牆會被修改，其他節點的 world matrix 不需要重算。
+    // 不會動的節點以 MatrixStack 排好 local matrix（Push、Translate / Rotate / Scale、取 Top、Pop）
+    SceneGraph scene(&thread_pool);
+    std::uint32_t root = scene.AddNode();
+
+    std::uint32_t rickroll_node = scene.AddNode(root);
+    scene.SetMaterial(rickroll_node, rickroll_material);
+    std::vector<std::uint32_t> rickroll_nodes{ rickroll_node };
+
+    MatrixStack layout;
+    layout.Push();
+    layout.Translate(glm::vec3(0.0f, 10.0f, -5.0f));
+    layout.Scale(glm::vec3(20.0f, 20.0f, 0.0f));
+    std::uint32_t background_node = scene.AddNode(root, layout.Top());
+    scene.SetMaterial(background_node, background_material);
+    layout.Pop();
+
+    layout.Push();
+    layout.Rotate(glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    layout.Scale(glm::vec3(100.0f, 100.0f, 0.0f));
+    std::uint32_t floor_node = scene.AddNode(root, layout.Top());
+    scene.SetMaterial(floor_node, floor_material);
+    layout.Pop();
+
+    int columns = std::max(1, static_cast<int>(std::sqrt(static_cast<float>(extra_quads))));
+    int rows = (extra_quads + columns - 1) / columns;
+    std::uint32_t wall_node = scene.AddNode(root);
+    for (int i = 0; i < extra_quads; ++i) {
+        float x = static_cast<float>(i % columns) - columns * 0.5f;
+        float y = static_cast<float>(i / columns) - rows * 0.5f;
+        layout.Push();
+        layout.Translate(glm::vec3(x * 0.6f, y * 0.6f, 0.0f));
+        layout.Scale(glm::vec3(0.5f, 0.5f, 0.0f));
+        std::uint32_t node = scene.AddNode(wall_node, layout.Top());
+        scene.SetMaterial(node, rickroll_material);
+        rickroll_nodes.push_back(node);
+        layout.Pop();
     }
+    std::size_t scene_updated = 0;
+    std::size_t quads_drawn = 0;
+
+    // headless 時不開音效，CI 或 render node 上通常沒有音效裝置
+    Mix_Music *music = nullptr;
+    if (!headless) {
+        int mix_flags = MIX_INIT_MP3;
+        int initted = Mix_Init(flags);
+        if(initted & flags != flags) {
+            printf("Mix_Init: Failed to init required mp3 support!\n");
+            printf("Mix_Init: %s\n", Mix_GetError());
+            exit(1);
+        }
 
-    if(Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 1024) < 0) {
-        printf("Mix_OpenAudio failed \n", Mix_GetError());
-        Mix_CloseAudio();
-        exit(1);
+        if(Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 1024) < 0) {
+            printf("Mix_OpenAudio failed \n", Mix_GetError());
+            Mix_CloseAudio();
+            exit(1);
+        }
+        music = Mix_LoadMUS("assets/sounds/bg.mp3");
+        Mix_PlayMusic(music, 1);
     }
-    Mix_Music *music = Mix_LoadMUS("assets/sounds/bg.mp3");
-    Mix_PlayMusic(music, 1);
 
     bool isDone = false;
+    int frame = 0;
+    std::vector<float> frame_times;
+    std::vector<float> cpu_times;
+    std::unique_ptr<GpuTimer> gpu_timer = benchmarking ? std::make_unique<GpuTimer>() : nullptr;
+
+    // GL_TIME_ELAPSED query 不能重疊，benchmark 已經用它量整個 frame，所以只記錄 CPU zone
+    std::unique_ptr<profiler::GpuProfiler> gpu_profiler = nullptr;
+    if (profiling && benchmarking) {
+        std::cout << "GPU zones are not recorded while benchmarking" << std::endl;
+    } else if (profiling) {
+        gpu_profiler = std::make_unique<profiler::GpuProfiler>();
+    }
+    profiler::Clock::time_point profile_start = profiler::Clock::now();
+    auto last_frame = std::chrono::steady_clock::now();
+    auto next_frame = last_frame;
+
+    // 模擬以固定的 tick 推進，跟 frame rate 無關；benchmark 的相機先放在路徑的起點，第一個 tick 才有上一個位置可以內插
+    FixedTimestep timestep(tick_rate);
+    if (benchmarking) {
+        benchmark::FollowCameraPath(*my_camera, 0.0f);
+        my_camera->Step(0.0f);
+    }
 
     while (!isDone) {
-        // 計算每 frame 的變化時間
-        current_time = static_cast<float>(SDL_GetTicks()) / 1000.0f;
-        delta_time = current_time - last_time;
-        last_time = current_time;
-
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            switch (event.type) {
-                case SDL_QUIT:
-                    isDone = true;
-                    break;
-                case SDL_KEYDOWN: {
-                    switch (event.key.keysym.sym) {
-                        case SDLK_TAB:
-                            my_camera->ToggleMouseControl();
-                            break;
-                        case SDLK_q:
-                            if (KMOD_CTRL & event.key.keysym.mod) {
-                                isDone = true;
-                            }
-                            break;
-                    }
-                } break;
+        // 計算每 frame 的變化時間（SDL_GetTicks 只有 1ms 的精度，所以改用 steady_clock）
+        // headless 不管實際跑多快都當作經過了 1/60 秒，模擬可以比即時更快地跑完，每次輸出的畫面也都一樣
+        auto now = std::chrono::steady_clock::now();
+        delta_time = headless ? 1.0f / 60.0f : std::chrono::duration<float>(now - last_frame).count();
+
+        frame_times.push_back(std::chrono::duration<float, std::milli>(now - last_frame).count());
+        last_frame = now;
+        auto cpu_start = now;
+
+        // 第一個 frame 包含了載入的時間，profile 的統計從第二個 frame 開始
+        if (frame == 1) {
+            profile_start = profiler::Clock::now();
+        }
+        PROFILE_ZONE("Frame");
+        if (gpu_profiler) {
+            gpu_profiler->BeginFrame();
+        }
+
+        {
+            PROFILE_ZONE("Events");
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+#ifdef TEXTURE_FUN_PROFILER_OVERLAY
+                if (show_overlay) {
+                    ImGui_ImplSDL2_ProcessEvent(&event);
+                }
+#endif
+                switch (event.type) {
+                    case SDL_QUIT:
+                        isDone = true;
+                        break;
+                    case SDL_KEYDOWN: {
+                        switch (event.key.keysym.sym) {
+                            case SDLK_TAB:
+                                my_camera->ToggleMouseControl();
+                                break;
+                            case SDLK_q:
+                                if (KMOD_CTRL & event.key.keysym.mod) {
+                                    isDone = true;
+                                }
+                                break;
+                        }
+                    } break;
+                }
             }
         }
 
-        my_camera->ProcessKeyboard();
-        my_camera->ProcessMouseMovement();
-        my_camera->Update(delta_time);
+        // 滑鼠是這個 frame 累積的相對位移，每個 frame 處理一次；鍵盤是按住的狀態，每個 tick 處理一次
+        {
+            PROFILE_ZONE("Simulation");
+            if (!benchmarking) {
+                my_camera->ProcessMouseMovement();
+            }
+            int ticks = timestep.Advance(delta_time);
+            for (int i = 0; i < ticks; ++i) {
+                if (!benchmarking) {
+                    my_camera->ProcessKeyboard();
+                }
+                my_camera->Step(static_cast<float>(timestep.Step()));
+                timestep.Tick();
+                if (benchmarking) {
+                    benchmark::FollowCameraPath(*my_camera, static_cast<float>(timestep.Time()));
+                }
+            }
+        }
+
+        // 畫面呈現上一個與目前的 tick 之間的狀態；flipbook 與場景的動畫都只由這個模擬時鐘決定，跟 frame rate 無關
+        current_time = static_cast<float>(timestep.RenderTime());
+        my_camera->Interpolate(timestep.Alpha());
+
+        if (gpu_timer) {
+            gpu_timer->Begin();
+        }
 
         // 設定 View 以及 Projection Matrix
         glm::mat4 view = my_camera->View();
         glm::mat4 projection = my_camera->Projection();
 
-        my_shader->Use();
-        my_shader->SetMat4("view", view);
-        my_shader->SetMat4("projection", projection);
-        my_shader->SetInt("ourTexture", 0);
+        camera_ubo->SetMat4("view", view);
+        camera_ubo->SetMat4("projection", projection);
+        {
+            profiler::ScopedGpuZone gpu_zone(gpu_profiler.get(), "Upload uniforms");
+            camera_ubo->Upload();
+        }
 
-        glViewport(0, 0, window_width, window_height);
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        {
+            profiler::ScopedGpuZone gpu_zone(gpu_profiler.get(), "Clear");
+            glViewport(0, 0, window_width, window_height);
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
 
         glActiveTexture(GL_TEXTURE0);
-        glBindVertexArray(vao);
-
-        model->Push();
-        model->Save(glm::translate(model->Top(), glm::vec3((glm::sin(current_time * 3.4333f) * 2) - 1, 0.0, 0.0f)));
-        model->Save(glm::translate(model->Top(), glm::vec3(0.0, 8.0, 0.0f)));
-        model->Save(glm::scale(model->Top(), glm::vec3(16.0, 16.0, 0.0f)));
-        rickroll[static_cast<int>(current_time * keyFrameRate) % 28]->Bind();
-        my_shader->SetMat4("model", model->Top());
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        model->Pop();
-
-        model->Push();
-        my_background->Bind();
-        model->Save(glm::translate(model->Top(), glm::vec3(0.0, 10.0, -5.0f)));
-        model->Save(glm::scale(model->Top(), glm::vec3(20.0, 20.0, 0.0f)));
-        my_shader->SetMat4("model", model->Top());
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        model->Pop();
-
-        model->Push();
-        my_background->Bind();
-        model->Save(glm::rotate(model->Top(), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f)));
-        model->Save(glm::scale(model->Top(), glm::vec3(100.0, 100.0, 0.0f)));
-        my_shader->SetMat4("model", model->Top());
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        model->Pop();
-
-        SDL_GL_SwapWindow(window);
+
+        {
+            profiler::ScopedGpuZone gpu_zone(gpu_profiler.get(), "Upload GIF frame");
+            if (rickroll) {
+                rickroll->Update(current_time);
+            }
+        }
+        if (rickroll_frames) {
+            float layer = FlipbookLayer(rickroll_start_times, current_time);
+            for (std::uint32_t node : rickroll_nodes) {
+                scene.SetMaterial(node, rickroll_material, layer);
+            }
+        }
+
+        scene.SetTransform(rickroll_node, glm::vec3((glm::sin(current_time * 3.4333f) * 2) - 1, 8.0f, 0.0f), 0.0f,
+            glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(16.0f, 16.0f, 0.0f));
+        if (extra_quads > 0) {
+            scene.SetTransform(wall_node, glm::vec3(0.0f, rows * 0.3f, -10.0f), current_time * 0.5f,
+                glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f));
+        }
+        // 貼圖可能被刪掉或剛載入完成，每個 frame 重新取得
+        residency.Update();
+        if (!my_background) {
+            GLuint texture = residency.Acquire(background_handle);
+            quads->SetTexture(background_material, texture);
+            quads->SetTexture(floor_material, texture);
+        }
+
+        scene_updated = scene.Update();
+        quads_drawn = scene.Submit(*quads, &my_camera->ViewFrustum);
+
+        {
+            profiler::ScopedGpuZone gpu_zone(gpu_profiler.get(), "Draw quads");
+            quads->Flush();
+        }
+
+#ifdef TEXTURE_FUN_PROFILER_OVERLAY
+        if (show_overlay) {
+            PROFILE_ZONE("Overlay");
+            profiler::ScopedGpuZone gpu_zone(gpu_profiler.get(), "Overlay");
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplSDL2_NewFrame();
+            ImGui::NewFrame();
+            profiler::DrawOverlay();
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+#endif
+
+        if (gpu_timer) {
+            gpu_timer->End();
+        }
+        cpu_times.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - cpu_start).count());
+        if (!dump_directory.empty() && frame % dump_every == 0) {
+            offscreen::DumpFrame(dump_directory, frame, window_width, window_height);
+        }
+        {
+            PROFILE_ZONE("Present");
+            if (headless) {
+                glFinish();
+            } else {
+                SDL_GL_SwapWindow(window);
+            }
+        }
+
+        ++frame;
+        if (max_frames > 0 && frame >= max_frames) {
+            isDone = true;
+        }
+
+        // 限制 frame rate：睡到下一個 frame 的時間點，落後太多就從現在重新開始算
+        if (!headless && fps_limit > 0) {
+            next_frame += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / fps_limit));
+            auto after = std::chrono::steady_clock::now();
+            if (next_frame < after) {
+                next_frame = after;
+            } else {
+                std::this_thread::sleep_until(next_frame);
+            }
+        }
+    }
+
+    // 第一個 frame 包含了載入的時間，不列入統計
+    benchmark::Report report;
+    report.renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    report.frames = frame;
+    report.quads = extra_quads;
+    report.frame = FrameStats::From(frame_times);
+    report.cpu = FrameStats::From(cpu_times);
+    if (gpu_timer) {
+        gpu_timer->Finish();
+        report.gpu = FrameStats::From(gpu_timer->Samples());
+    }
+
+    benchmark::Print(PixelUploader::Default().enabled ? "Frame time (upload ring)" : "Frame time (direct upload)", report.frame);
+    std::cout << "Quads per frame: " << quads_drawn << " of " << extra_quads + 3 << " after culling in " << quads->DrawCalls() << " draw calls, "
+              << scene_updated << " of " << scene.Size() << " scene nodes updated" << std::endl;
+    benchmark::Print("CPU time per frame", report.cpu);
+    benchmark::Print("GPU time per frame", report.gpu);
+    const TextureResidency::Stats& residency_stats = residency.GetStats();
+    std::cout << "Texture residency: " << residency.ResidentBytes() / 1024 << " KiB of "
+              << (residency.Budget() ? std::to_string(residency.Budget() >> 20) + " MiB" : std::string("unlimited"))
+              << ", " << residency_stats.loads << " loads, " << residency_stats.evictions << " evictions, "
+              << residency_stats.misses << " misses" << std::endl;
+    std::cout << "Texture cache: " << TextureCache::Default().hits << " hits, " << TextureCache::Default().misses
+              << " misses, " << TextureCache::Default().Size() << " textures (" << TextureCache::Default().ResidentBytes() / 1024
+              << " KiB) shared" << std::endl;
+    std::cout << "Simulated " << timestep.Ticks() << " ticks at " << timestep.TickRate() << " Hz ("
+              << timestep.Time() << " s)" << std::endl;
+
+    if (gpu_profiler) {
+        gpu_profiler->Finish();
+    }
+    if (profiling) {
+        profiler::PrintSummary(profile_start, profiler::Clock::now(), frame - 1);
+        if (gpu_profiler) {
+            std::cout << "GPU zone results read back late: " << gpu_profiler->Stalls() << " times" << std::endl;
+        }
+    }
+    if (!trace_file.empty() && profiler::WriteChromeTrace(trace_file)) {
+        std::cout << "Trace written to " << trace_file << std::endl;
+    }
+
+    int exit_code = 0;
+    if (benchmarking) {
+        if (!benchmark::WriteJson(benchmark_report, report)) {
+            exit_code = 1;
+        } else {
+            std::cout << "Benchmark report written to " << benchmark_report << std::endl;
+        }
+        if (!benchmark_baseline.empty() &&
+            !benchmark::CompareWithBaseline(benchmark_baseline, report, benchmark_threshold)) {
+            exit_code = 1;
+        }
     }
 
+    gpu_timer.reset();
+    gpu_profiler.reset();
+#ifdef TEXTURE_FUN_PROFILER_OVERLAY
+    if (show_overlay) {
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui_ImplSDL2_Shutdown();
+        ImGui::DestroyContext();
+    }
+#endif
+    offscreen_target.reset();
+    // 在 SDL 刪除 context 之前釋放 PBO ring，不能留給 static 的解構子
+    PixelUploader::Default().Shutdown();
     Mix_FreeMusic(music);
     SDL_DestroyWindow(window);
     SDL_Quit();
-    return 0;
+    return exit_code;
 }
\ No newline at end of file
@@ -1,2 +1,7 @@
+#ifdef TEXTURE_FUN_FAST_INFLATE
+#include "Inflate.hpp"
+#define STBI_ZLIB_DECODE_OVERRIDE fast_inflate::DecodeZlibMalloc
+#endif
+
 #define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
\ No newline at end of file
+#include "stb_image.h"
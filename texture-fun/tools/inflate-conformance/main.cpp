@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Inflate.hpp"
+#include "stb_image.h"
+
+namespace fs = std::filesystem;
+
+// 確認 fast_inflate 與 stb_image 內建的 zlib 解出完全相同的資料。
+// 這個工具編譯時不定義 TEXTURE_FUN_FAST_INFLATE，stb_image 使用的是原本的實作，當作參考答案；
+// 每張 PNG 的 IDAT 串起來之後分別交給兩邊解壓縮，長度或任何一個 byte 不同就以非零值結束。
+//
+//   inflate-conformance [檔案或資料夾]...
+//
+// 沒有指定時檢查 assets/textures 底下所有的 PNG。
+
+static std::uint32_t ReadU32(const unsigned char* p) {
+    return (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16) |
+           (static_cast<std::uint32_t>(p[2]) << 8) | static_cast<std::uint32_t>(p[3]);
+}
+
+// 把所有 IDAT chunk 的內容依序串起來，就是完整的 zlib stream
+static bool ReadIdat(const fs::path& path, std::vector<char>& idat) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    static const unsigned char kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (data.size() < 8 || !std::equal(kSignature, kSignature + 8, data.begin())) {
+        return false;
+    }
+
+    idat.clear();
+    std::size_t offset = 8;
+    while (offset + 12 <= data.size()) {
+        std::size_t length = ReadU32(&data[offset]);
+        const unsigned char* type = &data[offset + 4];
+        if (length > data.size() - offset - 12) {
+            return false;
+        }
+        if (std::equal(type, type + 4, "IDAT")) {
+            idat.insert(idat.end(), data.begin() + offset + 8, data.begin() + offset + 8 + length);
+        }
+        if (std::equal(type, type + 4, "IEND")) {
+            break;
+        }
+        offset += 12 + length;
+    }
+    return !idat.empty();
+}
+
+static bool Check(const fs::path& path) {
+    std::vector<char> idat;
+    if (!ReadIdat(path, idat)) {
+        std::cout << "FAIL " << path.string() << ": not a PNG or no IDAT chunk" << std::endl;
+        return false;
+    }
+
+    const int len = static_cast<int>(idat.size());
+    int reference_len = 0;
+    int fast_len = 0;
+    char* reference = stbi_zlib_decode_malloc_guesssize_headerflag(idat.data(), len, len * 4, &reference_len, 1);
+    char* fast = fast_inflate::DecodeZlibMalloc(idat.data(), len, len * 4, &fast_len, 1);
+
+    bool ok = false;
+    if (reference == nullptr) {
+        std::cout << "FAIL " << path.string() << ": stb_image could not inflate the reference stream" << std::endl;
+    } else if (fast == nullptr) {
+        std::cout << "FAIL " << path.string() << ": fast_inflate rejected a stream stb_image accepts" << std::endl;
+    } else if (fast_len != reference_len) {
+        std::cout << "FAIL " << path.string() << ": " << fast_len << " bytes, expected " << reference_len << std::endl;
+    } else {
+        auto mismatch = std::mismatch(reference, reference + reference_len, fast);
+        if (mismatch.first != reference + reference_len) {
+            std::cout << "FAIL " << path.string() << ": first difference at byte " << (mismatch.first - reference)
+                      << " of " << reference_len << std::endl;
+        } else {
+            std::cout << "ok   " << path.string() << " (" << reference_len << " bytes)" << std::endl;
+            ok = true;
+        }
+    }
+
+    std::free(reference);
+    std::free(fast);
+    return ok;
+}
+
+static void Collect(const fs::path& path, std::vector<fs::path>& files) {
+    auto is_png = [](const fs::path& p) {
+        std::string extension = p.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        return extension == ".png";
+    };
+
+    if (fs::is_directory(path)) {
+        for (const auto& entry : fs::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file() && is_png(entry.path())) {
+                files.push_back(entry.path());
+            }
+        }
+    } else {
+        files.push_back(path);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<fs::path> files;
+    if (argc == 1) {
+        Collect("assets/textures", files);
+    }
+    for (int i = 1; i < argc; ++i) {
+        Collect(argv[i], files);
+    }
+    std::sort(files.begin(), files.end());
+
+    if (files.empty()) {
+        std::cout << "inflate-conformance: no PNG files found" << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    for (const fs::path& file : files) {
+        if (!Check(file)) {
+            ++failures;
+        }
+    }
+    std::cout << files.size() - failures << " / " << files.size() << " streams identical" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
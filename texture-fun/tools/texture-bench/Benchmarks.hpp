@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <utility>
+
+// 每一項 benchmark 印出自己的結果，失敗（例如找不到素材）時回傳非零值
+namespace bench {
+    // fn 執行一次所花的秒數
+    template <typename Fn>
+    double Seconds(Fn&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        std::forward<Fn>(fn)();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    int Decode();
+    int Mipmap();
+    int Defilter();
+    int Uniform();
+    int MatrixStackOps();
+    int Matrix();
+    int Culling();
+    int Storage();
+}
@@ -0,0 +1,83 @@
+#include "Benchmarks.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Frustum.hpp"
+#include "MatrixMath.hpp"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr std::size_t kCount = 4000000;
+
+    void Print(const char* name, double seconds, std::size_t visible) {
+        std::cout << std::fixed << std::setprecision(1) << "culling: " << std::setw(24) << std::left << name << std::right
+                  << " " << seconds * 1000.0 << " ms, " << kCount / seconds / 1.0e6 << " M/s (" << visible << " visible)"
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+// 400 萬個隨機散布的包圍球與 AABB，以 Frustum 的純量測試逐一呼叫，與 culling::CullSpheres / CullAabbs 的 SoA 批次測試比較；
+// 兩邊判斷出的可見性不同時視為失敗
+int bench::Culling() {
+    const glm::mat4 view_projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 500.0f) *
+        matrix::LookAt(glm::vec3(0.0f, 0.0f, 20.0f), glm::vec3(0.0f, 8.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = Frustum::FromMatrix(view_projection);
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> position(-300.0f, 300.0f);
+    std::uniform_real_distribution<float> size(0.0f, 5.0f);
+    std::vector<float> x(kCount), y(kCount), z(kCount), radius(kCount);
+    std::vector<float> extent_x(kCount), extent_y(kCount), extent_z(kCount);
+    for (std::size_t i = 0; i < kCount; ++i) {
+        x[i] = position(random);
+        y[i] = position(random);
+        z[i] = position(random);
+        radius[i] = size(random);
+        extent_x[i] = size(random);
+        extent_y[i] = size(random);
+        extent_z[i] = size(random);
+    }
+    std::vector<std::uint8_t> scalar(kCount);
+    std::vector<std::uint8_t> batched(kCount);
+
+    std::size_t visible = 0;
+    double seconds = bench::Seconds([&] {
+        for (std::size_t i = 0; i < kCount; ++i) {
+            scalar[i] = frustum.IntersectsSphere(glm::vec3(x[i], y[i], z[i]), radius[i]);
+            visible += scalar[i];
+        }
+    });
+    Print("spheres (scalar)", seconds, visible);
+    seconds = bench::Seconds([&] {
+        visible = culling::CullSpheres(frustum, x.data(), y.data(), z.data(), radius.data(), kCount, batched.data());
+    });
+    Print("spheres (CullSpheres)", seconds, visible);
+    bool spheres_match = scalar == batched;
+
+    visible = 0;
+    seconds = bench::Seconds([&] {
+        for (std::size_t i = 0; i < kCount; ++i) {
+            scalar[i] = frustum.IntersectsAabb(glm::vec3(x[i], y[i], z[i]), glm::vec3(extent_x[i], extent_y[i], extent_z[i]));
+            visible += scalar[i];
+        }
+    });
+    Print("AABBs (scalar)", seconds, visible);
+    seconds = bench::Seconds([&] {
+        visible = culling::CullAabbs(frustum, x.data(), y.data(), z.data(), extent_x.data(), extent_y.data(), extent_z.data(),
+            kCount, batched.data());
+    });
+    Print("AABBs (CullAabbs)", seconds, visible);
+    bool aabbs_match = scalar == batched;
+
+    if (!spheres_match || !aabbs_match) {
+        std::cout << "culling: batched results differ from the scalar tests" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "Benchmarks.hpp"
+
+#include "ImageCache.hpp"
+#include "TextureLoader.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr int kRounds = 5;
+
+    std::vector<std::string> ListImages(const fs::path& directory) {
+        std::vector<std::string> files;
+        std::error_code error;
+        for (const auto& entry : fs::recursive_directory_iterator(directory, error)) {
+            std::string extension = entry.path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+            if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg")) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+}
+
+// 以 TextureLoader 解碼 assets/textures 底下所有的 PNG / JPG。不經過磁碟快取，也不產生 mipmap，只計算解碼本身；
+// 分別以 1 條與所有的執行緒跑，MB/s 以解碼後的像素計算，括號中為壓縮檔的大小
+int bench::Decode() {
+    std::vector<std::string> files = ListImages("assets/textures");
+    if (files.empty()) {
+        std::cout << "decode: no images found under assets/textures" << std::endl;
+        return 1;
+    }
+
+    std::size_t source_bytes = 0;
+    for (const std::string& file : files) {
+        source_bytes += static_cast<std::size_t>(fs::file_size(file));
+    }
+
+    ImageCache uncached("");
+    std::vector<unsigned int> thread_counts{ 1 };
+    if (std::thread::hardware_concurrency() > 1) {
+        thread_counts.push_back(std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int threads : thread_counts) {
+        ThreadPool pool(threads);
+        TextureLoader loader(pool, uncached);
+        std::size_t pixel_bytes = 0;
+        bool failed = false;
+        double seconds = bench::Seconds([&] {
+            for (int round = 0; round < kRounds; ++round) {
+                for (const std::string& file : files) {
+                    loader.Enqueue(file);
+                }
+                TextureLoader::Result result;
+                while (loader.Pending() > 0) {
+                    if (!loader.Poll(result)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    failed = failed || !result.image.IsValid();
+                    pixel_bytes += result.image.Size();
+                }
+            }
+        });
+        if (failed) {
+            std::cout << "decode: failed to decode some of the images" << std::endl;
+            return 1;
+        }
+
+        double megabytes = pixel_bytes / 1.0e6;
+        double source_megabytes = source_bytes * kRounds / 1.0e6;
+        std::cout << std::fixed << std::setprecision(1) << "decode (" << threads << (threads == 1 ? " thread" : " threads")
+                  << "): " << files.size() << " images x " << kRounds << " in " << seconds * 1000.0 << " ms, "
+                  << megabytes / seconds << " MB/s (" << source_megabytes / seconds << " MB/s compressed)"
+                  << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
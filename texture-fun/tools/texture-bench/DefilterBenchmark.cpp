@@ -0,0 +1,120 @@
+#include "Benchmarks.hpp"
+
+#include "Image.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr int kWidth = 1920;
+    constexpr int kHeight = 1080;
+    constexpr int kRepeats = 5;
+
+    const char* const kFilterNames[] = { "None", "Sub", "Up", "Avg", "Paeth" };
+
+    void PutU32(std::vector<unsigned char>& out, std::uint32_t value) {
+        out.push_back(static_cast<unsigned char>(value >> 24));
+        out.push_back(static_cast<unsigned char>(value >> 16));
+        out.push_back(static_cast<unsigned char>(value >> 8));
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    std::uint32_t Crc32(const unsigned char* data, std::size_t size) {
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (std::size_t i = 0; i < size; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+        }
+        return ~crc;
+    }
+
+    void PutChunk(std::vector<unsigned char>& png, const char* type, const std::vector<unsigned char>& data) {
+        PutU32(png, static_cast<std::uint32_t>(data.size()));
+        std::size_t start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data.begin(), data.end());
+        PutU32(png, Crc32(png.data() + start, png.size() - start));
+    }
+
+    // 以 stored block（不壓縮）包成 zlib stream，inflate 只剩下 memcpy，解碼時間幾乎都花在 defilter 上
+    std::vector<unsigned char> StoredZlib(const std::vector<unsigned char>& raw) {
+        std::vector<unsigned char> out{ 0x78, 0x01 };
+        std::size_t offset = 0;
+        do {
+            std::size_t size = std::min<std::size_t>(raw.size() - offset, 65535);
+            bool final = offset + size == raw.size();
+            out.push_back(final ? 1 : 0);
+            out.push_back(static_cast<unsigned char>(size));
+            out.push_back(static_cast<unsigned char>(size >> 8));
+            out.push_back(static_cast<unsigned char>(~size));
+            out.push_back(static_cast<unsigned char>(~size >> 8));
+            out.insert(out.end(), raw.begin() + offset, raw.begin() + offset + size);
+            offset += size;
+        } while (offset < raw.size());
+
+        std::uint32_t a = 1, b = 0;
+        for (unsigned char value : raw) {
+            a = (a + value) % 65521;
+            b = (b + a) % 65521;
+        }
+        PutU32(out, (b << 16) | a);
+        return out;
+    }
+
+    // 每一列都使用同一種 filter。filter 之後的資料直接用亂數，解出來的像素是什麼並不重要
+    std::vector<unsigned char> MakePng(int channels, int filter) {
+        std::mt19937 random(1234);
+        std::vector<unsigned char> raw;
+        raw.reserve(static_cast<std::size_t>(kWidth * channels + 1) * kHeight);
+        for (int y = 0; y < kHeight; ++y) {
+            raw.push_back(static_cast<unsigned char>(filter));
+            for (int x = 0; x < kWidth * channels; ++x) {
+                raw.push_back(static_cast<unsigned char>(random()));
+            }
+        }
+
+        std::vector<unsigned char> png{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        std::vector<unsigned char> header;
+        PutU32(header, kWidth);
+        PutU32(header, kHeight);
+        header.push_back(8);                          // bit depth
+        header.push_back(channels == 4 ? 6 : 2);      // RGBA、RGB
+        header.push_back(0);
+        header.push_back(0);
+        header.push_back(0);
+        PutChunk(png, "IHDR", header);
+        PutChunk(png, "IDAT", StoredZlib(raw));
+        PutChunk(png, "IEND", {});
+        return png;
+    }
+}
+
+// 1920x1080 的 RGB 與 RGBA PNG，每張圖的所有列都用同一種 filter，量測各種 filter 的解碼速度（MB/s 以解碼後的像素計算）
+int bench::Defilter() {
+    for (int channels : { 3, 4 }) {
+        for (int filter = 0; filter < 5; ++filter) {
+            std::vector<unsigned char> png = MakePng(channels, filter);
+            std::size_t bytes = 0;
+            double seconds = bench::Seconds([&] {
+                for (int i = 0; i < kRepeats; ++i) {
+                    Image image(png.data(), png.size());
+                    bytes += image.Size();
+                }
+            });
+            if (bytes != static_cast<std::size_t>(kWidth) * kHeight * channels * kRepeats) {
+                std::cout << "defilter: failed to decode the " << kFilterNames[filter] << " image" << std::endl;
+                return 1;
+            }
+            std::cout << std::fixed << std::setprecision(1) << "defilter: " << (channels == 4 ? "RGBA " : "RGB  ")
+                      << std::setw(5) << std::left << kFilterNames[filter] << std::right << " " << seconds * 1000.0 / kRepeats
+                      << " ms, " << bytes / seconds / 1.0e6 << " MB/s" << std::defaultfloat << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "GlContext.hpp"
+
+#include <glad/glad.h>
+
+#include <iostream>
+
+GlContext::GlContext() : m_window(nullptr), m_context(nullptr), m_valid(false) {
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cout << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+#ifdef __APPLE__
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+#endif
+
+    m_window = SDL_CreateWindow("texture-bench", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 64, 64,
+        SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    if (m_window == nullptr) {
+        std::cout << "SDL_CreateWindow Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+    m_context = SDL_GL_CreateContext(m_window);
+    if (m_context == nullptr || SDL_GL_MakeCurrent(m_window, m_context) != 0 || !gladLoadGLLoader(SDL_GL_GetProcAddress)) {
+        std::cout << "Failed to create an OpenGL context: " << SDL_GetError() << std::endl;
+        return;
+    }
+    SDL_GL_SetSwapInterval(0);
+    m_valid = true;
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+}
+
+GlContext::~GlContext() {
+    if (m_context != nullptr) {
+        SDL_GL_DeleteContext(m_context);
+    }
+    if (m_window != nullptr) {
+        SDL_DestroyWindow(m_window);
+    }
+    SDL_Quit();
+}
+
+bool GlContext::IsValid() const {
+    return m_valid;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <SDL.h>
+
+// 隱藏視窗的 OpenGL 3.3 core context（跟 texture-fun --headless 的設定相同），給需要 GL 的 benchmark 使用。
+// 建立失敗時 IsValid() 為 false，呼叫者應該略過需要 GL 的項目。
+struct GlContext {
+    GlContext();
+    ~GlContext();
+
+    GlContext(const GlContext&) = delete;
+    GlContext& operator=(const GlContext&) = delete;
+
+    bool IsValid() const;
+
+private:
+    SDL_Window* m_window;
+    SDL_GLContext m_context;
+    bool m_valid;
+};
@@ -0,0 +1,99 @@
+#include "Benchmarks.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "MatrixMath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr std::size_t kCount = 100000;
+    constexpr int kRepeats = 20;
+    constexpr float kTolerance = 1.0e-3f;
+
+    // 平移 + 任意軸旋轉 + 非等比縮放，跟場景中 quad 的 local matrix 是同一類
+    glm::mat4 RandomAffine(std::mt19937& random) {
+        std::uniform_real_distribution<float> unit(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> scale(0.2f, 3.0f);
+        glm::mat4 m(1.0f);
+        m = glm::translate(m, glm::vec3(unit(random), unit(random), unit(random)) * 5.0f);
+        m = glm::rotate(m, unit(random) * 1.5f, glm::vec3(unit(random), unit(random), unit(random)));
+        m = glm::scale(m, glm::vec3(scale(random), scale(random), scale(random)));
+        return m;
+    }
+
+    // 以 b 為準的最大相對誤差
+    float MaxError(const std::vector<glm::mat4>& a, const std::vector<glm::mat4>& b) {
+        float error = 0.0f;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            for (int column = 0; column < 4; ++column) {
+                for (int row = 0; row < 4; ++row) {
+                    float expected = b[i][column][row];
+                    error = std::max(error, std::fabs(a[i][column][row] - expected) / std::max(1.0f, std::fabs(expected)));
+                }
+            }
+        }
+        return error;
+    }
+
+    void Print(const char* name, double seconds) {
+        std::cout << std::fixed << std::setprecision(2) << "matrix: " << std::setw(32) << std::left << name << std::right
+                  << " " << seconds * 1000.0 / kRepeats << " ms" << std::defaultfloat << std::endl;
+    }
+}
+
+// 一次轉換 10 萬個矩陣：parent * local 的 glm 迴圈與 matrix::MultiplyBatch，以及 glm::inverse 與 matrix::AffineInverse。
+// 兩邊的結果誤差超過 kTolerance 時視為失敗
+int bench::Matrix() {
+    std::mt19937 random(7);
+    std::vector<glm::mat4> locals(kCount);
+    for (glm::mat4& local : locals) {
+        local = RandomAffine(random);
+    }
+    const glm::mat4 parent = RandomAffine(random);
+    std::vector<glm::mat4> expected(kCount);
+    std::vector<glm::mat4> actual(kCount);
+
+    Print("parent * local (glm loop)", bench::Seconds([&] {
+        for (int i = 0; i < kRepeats; ++i) {
+            for (std::size_t j = 0; j < kCount; ++j) {
+                expected[j] = parent * locals[j];
+            }
+        }
+    }));
+    Print("matrix::MultiplyBatch", bench::Seconds([&] {
+        for (int i = 0; i < kRepeats; ++i) {
+            matrix::MultiplyBatch(parent, locals.data(), actual.data(), kCount);
+        }
+    }));
+    float multiply_error = MaxError(actual, expected);
+
+    Print("glm::inverse", bench::Seconds([&] {
+        for (int i = 0; i < kRepeats; ++i) {
+            for (std::size_t j = 0; j < kCount; ++j) {
+                expected[j] = glm::inverse(locals[j]);
+            }
+        }
+    }));
+    Print("matrix::AffineInverse", bench::Seconds([&] {
+        for (int i = 0; i < kRepeats; ++i) {
+            for (std::size_t j = 0; j < kCount; ++j) {
+                actual[j] = matrix::AffineInverse(locals[j]);
+            }
+        }
+    }));
+    float inverse_error = MaxError(actual, expected);
+
+    std::cout << "matrix: max relative error " << multiply_error << " (multiply), " << inverse_error << " (inverse)" << std::endl;
+    if (multiply_error > kTolerance || inverse_error > kTolerance) {
+        std::cout << "matrix: results differ from glm" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "Benchmarks.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "MatrixStack.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <stack>
+
+namespace {
+    constexpr int kIterations = 2000000;
+    constexpr int kDeepIterations = 200000;
+    constexpr int kDepth = 24;
+
+    // 改版之前的 MatrixStack：std::stack<glm::mat4>，修改 Top 時要先複製出來，算完再 Pop + Push 存回去
+    struct StdStack {
+        std::stack<glm::mat4> stack;
+
+        StdStack() { stack.push(glm::mat4(1.0f)); }
+        void Push() { stack.push(stack.top()); }
+        void Pop() { stack.pop(); }
+        glm::mat4 Top() const { return stack.top(); }
+        void Save(const glm::mat4& matrix) {
+            stack.pop();
+            stack.push(matrix);
+        }
+    };
+
+    void Print(const char* name, double seconds, int count, const char* unit) {
+        std::cout << std::fixed << std::setprecision(1) << "matrix-stack: " << std::setw(32) << std::left << name << std::right
+                  << " " << seconds * 1.0e9 / count << " ns/" << unit << std::defaultfloat << std::endl;
+    }
+}
+
+// 場景中典型的一段：push / translate / push / rotate / scale / pop / pop，以及反覆推到 24 層再全部 pop
+int bench::MatrixStackOps() {
+    // volatile 讓編譯器不能把整個迴圈拿掉
+    volatile float sink = 0.0f;
+
+    StdStack old_stack;
+    Print("std::stack<glm::mat4>", bench::Seconds([&] {
+        for (int i = 0; i < kIterations; ++i) {
+            old_stack.Push();
+            old_stack.Save(glm::translate(old_stack.Top(), glm::vec3(i * 0.001f, 1.0f, 2.0f)));
+            old_stack.Push();
+            old_stack.Save(glm::rotate(old_stack.Top(), i * 0.01f, glm::vec3(0.0f, 0.0f, 1.0f)));
+            old_stack.Save(glm::scale(old_stack.Top(), glm::vec3(0.5f, 0.5f, 1.0f)));
+            sink += old_stack.Top()[3][0];
+            old_stack.Pop();
+            old_stack.Pop();
+        }
+    }), kIterations, "iteration");
+
+    MatrixStack stack;
+    Print("MatrixStack", bench::Seconds([&] {
+        for (int i = 0; i < kIterations; ++i) {
+            stack.Push();
+            stack.Translate(glm::vec3(i * 0.001f, 1.0f, 2.0f));
+            stack.Push();
+            stack.Rotate(i * 0.01f, glm::vec3(0.0f, 0.0f, 1.0f));
+            stack.Scale(glm::vec3(0.5f, 0.5f, 1.0f));
+            sink += stack.Top()[3][0];
+            stack.Pop();
+            stack.Pop();
+        }
+    }), kIterations, "iteration");
+
+    Print("std::stack<glm::mat4>, 24 deep", bench::Seconds([&] {
+        for (int i = 0; i < kDeepIterations; ++i) {
+            for (int depth = 0; depth < kDepth; ++depth) {
+                old_stack.Push();
+                old_stack.Save(glm::translate(old_stack.Top(), glm::vec3(1.0f, 0.0f, 0.0f)));
+            }
+            sink += old_stack.Top()[3][0];
+            for (int depth = 0; depth < kDepth; ++depth) {
+                old_stack.Pop();
+            }
+        }
+    }), kDeepIterations * kDepth, "push");
+
+    Print("MatrixStack, 24 deep", bench::Seconds([&] {
+        for (int i = 0; i < kDeepIterations; ++i) {
+            for (int depth = 0; depth < kDepth; ++depth) {
+                stack.Push();
+                stack.Translate(glm::vec3(1.0f, 0.0f, 0.0f));
+            }
+            sink += stack.Top()[3][0];
+            for (int depth = 0; depth < kDepth; ++depth) {
+                stack.Pop();
+            }
+        }
+    }), kDeepIterations * kDepth, "push");
+    return 0;
+}
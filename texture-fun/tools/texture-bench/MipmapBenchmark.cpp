@@ -0,0 +1,89 @@
+#include "Benchmarks.hpp"
+#include "GlContext.hpp"
+
+#include <glad/glad.h>
+
+#include "Image.hpp"
+#include "Mipmap.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+namespace {
+    constexpr int kRepeats = 10;
+
+    GLenum PixelFormat(int channels) {
+        return channels == 4 ? GL_RGBA : channels == 3 ? GL_RGB : GL_RED;
+    }
+
+    GLenum InternalFormat(int channels) {
+        return channels == 4 ? GL_RGBA8 : channels == 3 ? GL_RGB8 : GL_R8;
+    }
+
+    void Print(const char* name, double seconds) {
+        std::cout << std::fixed << std::setprecision(2) << "mipmap: " << name << ": " << seconds * 1000.0 / kRepeats
+                  << " ms" << std::defaultfloat << std::endl;
+    }
+}
+
+// background.png 的整條 mip chain：CPU 上的 Box / SrgbBox（在 worker 上執行的部分），
+// 以及 GL 執行緒上的成本：glGenerateMipmap，或是把 CPU 產生好的每一層上傳（都含 glFinish）
+int bench::Mipmap() {
+    Image source("assets/textures/background.png");
+    if (!source.IsValid()) {
+        std::cout << "mipmap: failed to load assets/textures/background.png" << std::endl;
+        return 1;
+    }
+    std::cout << "mipmap: background.png " << source.width << "x" << source.height << ", " << source.channels
+              << " channels, " << mipmap::LevelCount(source.width, source.height) << " levels" << std::endl;
+
+    Image chain = source;
+    Print("CPU Box", bench::Seconds([&] {
+        for (int i = 0; i < kRepeats; ++i) {
+            mipmap::Generate(chain, MipmapFilter::Box);
+        }
+    }));
+    Print("CPU SrgbBox", bench::Seconds([&] {
+        for (int i = 0; i < kRepeats; ++i) {
+            mipmap::Generate(chain, MipmapFilter::SrgbBox);
+        }
+    }));
+
+    GlContext context;
+    if (!context.IsValid()) {
+        return 1;
+    }
+
+    const GLenum format = PixelFormat(source.channels);
+    const GLenum internal_format = InternalFormat(source.channels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, source.width, source.height, 0, format, GL_UNSIGNED_BYTE, source.pixels.get());
+
+    // 第一次呼叫會配置 level 1 以後的空間，不列入計算
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glFinish();
+    Print("glGenerateMipmap", bench::Seconds([&] {
+        for (int i = 0; i < kRepeats; ++i) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        glFinish();
+    }));
+
+    Print("upload CPU chain (levels 1..n)", bench::Seconds([&] {
+        for (int i = 0; i < kRepeats; ++i) {
+            for (std::size_t level = 0; level < chain.mipmaps.size(); ++level) {
+                const Image::MipLevel& mip = chain.mipmaps[level];
+                glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level + 1), 0, 0, mip.width, mip.height, format,
+                    GL_UNSIGNED_BYTE, mip.pixels.get());
+            }
+        }
+        glFinish();
+    }));
+
+    glDeleteTextures(1, &texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    return 0;
+}
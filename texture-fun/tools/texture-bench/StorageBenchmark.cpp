@@ -0,0 +1,168 @@
+#include "Benchmarks.hpp"
+#include "GlContext.hpp"
+
+#include <glad/glad.h>
+
+#include "Image.hpp"
+#include "Mipmap.hpp"
+#include "PixelUploader.hpp"
+#include "Texture.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr int kUploads = 10;
+    constexpr int kTextures = 8;
+    constexpr int kDraws = 20000;
+
+    // 只取樣貼圖的最小 shader，畫進 16x16 的 FBO，量到的主要是 Bind 之後 draw 時 driver 的檢查
+    const char* kVertexShader = R"(#version 330 core
+out vec2 TexCoord;
+void main() {
+    vec2 position = vec2((gl_VertexID & 1) * 4 - 1, (gl_VertexID & 2) * 2 - 1);
+    TexCoord = position * 0.5 + 0.5;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+)";
+    const char* kFragmentShader = R"(#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+uniform sampler2D ourTexture;
+void main() {
+    FragColor = texture(ourTexture, TexCoord);
+}
+)";
+
+    GLuint CompileProgram() {
+        GLuint program = glCreateProgram();
+        for (GLenum type : { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER }) {
+            GLuint shader = glCreateShader(type);
+            const char* source = type == GL_VERTEX_SHADER ? kVertexShader : kFragmentShader;
+            glShaderSource(shader, 1, &source, nullptr);
+            glCompileShader(shader);
+            glAttachShader(program, shader);
+            glDeleteShader(shader);
+        }
+        glLinkProgram(program);
+        GLint linked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            glDeleteProgram(program);
+            return 0;
+        }
+        return program;
+    }
+
+    void Print(const char* name, const char* unit, double value) {
+        std::cout << std::fixed << std::setprecision(2) << "storage: " << std::setw(34) << std::left << name << std::right << " "
+                  << value << " " << unit << std::defaultfloat << std::endl;
+    }
+
+    const char* Label(bool immutable) {
+        return immutable ? "glTexStorage2D" : "glTexImage2D  ";
+    }
+}
+
+// immutable（glTexStorage2D + glTexSubImage2D）與 mutable（逐層 glTexImage2D）兩種配置方式：
+// 經由 Texture 建立 background.png 的時間（glGenerateMipmap 與預先算好的 CPU mip chain 兩種，都含 glFinish），
+// 以及輪流 Bind kTextures 張貼圖各畫一個三角形的成本
+int bench::Storage() {
+    Image source("assets/textures/background.png");
+    if (!source.IsValid()) {
+        std::cout << "storage: failed to load assets/textures/background.png" << std::endl;
+        return 1;
+    }
+    // mip chain 先算好，上傳的時間才不包含 CPU 的縮小
+    Image chain = source;
+    mipmap::Generate(chain, MipmapFilter::SrgbBox);
+
+    GlContext context;
+    if (!context.IsValid()) {
+        return 1;
+    }
+    std::cout << "storage: background.png " << source.width << "x" << source.height << ", " << source.channels << " channels" << std::endl;
+
+    // 第一次上傳會建立 PBO ring 與 driver 內部的資源，不列入計算
+    Texture(source, TextureOptions());
+    glFinish();
+
+    for (bool immutable : { true, false }) {
+        TextureOptions options;
+        options.immutable_storage = immutable;
+
+        std::string name = std::string(Label(immutable)) + " + glGenerateMipmap";
+        Print(name.c_str(), "ms/texture", bench::Seconds([&] {
+            for (int i = 0; i < kUploads; ++i) {
+                Texture texture(source, options);
+                glFinish();
+            }
+        }) * 1000.0 / kUploads);
+
+        options.mipmap_filter = MipmapFilter::SrgbBox;
+        name = std::string(Label(immutable)) + " + CPU mip chain";
+        Print(name.c_str(), "ms/texture", bench::Seconds([&] {
+            for (int i = 0; i < kUploads; ++i) {
+                Texture texture(chain, options);
+                glFinish();
+            }
+        }) * 1000.0 / kUploads);
+    }
+
+    GLuint program = CompileProgram();
+    if (program == 0) {
+        std::cout << "storage: failed to compile the sampling shader" << std::endl;
+        PixelUploader::Default().Shutdown();
+        return 1;
+    }
+    GLuint framebuffer = 0;
+    GLuint color = 0;
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 16, 16);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    glViewport(0, 0, 16, 16);
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "ourTexture"), 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    for (bool immutable : { true, false }) {
+        TextureOptions options;
+        options.immutable_storage = immutable;
+        std::vector<std::unique_ptr<Texture>> textures;
+        for (int i = 0; i < kTextures; ++i) {
+            textures.push_back(std::make_unique<Texture>(source, options));
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        }
+        // 第一次 draw 時 driver 才會編譯 shader 的最終版本，不列入計算
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glFinish();
+
+        std::string name = std::string(Label(immutable)) + " Bind + draw";
+        Print(name.c_str(), "us/draw", bench::Seconds([&] {
+            for (int i = 0; i < kDraws; ++i) {
+                textures[i % kTextures]->Bind();
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+            }
+            glFinish();
+        }) * 1.0e6 / kDraws);
+    }
+
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &vao);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &color);
+    glUseProgram(0);
+    glDeleteProgram(program);
+    PixelUploader::Default().Shutdown();
+    return 0;
+}
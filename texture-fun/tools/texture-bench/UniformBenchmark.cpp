@@ -0,0 +1,82 @@
+#include "Benchmarks.hpp"
+#include "GlContext.hpp"
+
+#include <glad/glad.h>
+
+#include "Shader.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+namespace {
+    constexpr int kIterations = 5000000;
+
+    // 改版之前 Shader 的作法：以字串為 key 的 unordered_map，第一次查不到時才問 driver
+    struct StringMapLookup {
+        GLuint program;
+        std::unordered_map<std::string, GLint> locations;
+
+        GLint Get(const std::string& name) {
+            auto it = locations.find(name);
+            if (it != locations.end()) {
+                return it->second;
+            }
+            return locations[name] = glGetUniformLocation(program, name.c_str());
+        }
+    };
+
+    void Print(const char* name, double seconds) {
+        std::cout << std::fixed << std::setprecision(1) << "uniform: " << std::setw(28) << std::left << name << std::right
+                  << " " << seconds * 1.0e9 / kIterations << " ns/call" << std::defaultfloat << std::endl;
+    }
+}
+
+// 每次 SetInt 的成本：字串版本（執行期雜湊 + 二分搜尋）、UniformHandle 版本（編譯期雜湊 + 二分搜尋）、
+// 舊的 unordered_map<string, GLint>，以及直接以已知的 location 呼叫 glUniform1i 當作下限
+int bench::Uniform() {
+    GlContext context;
+    if (!context.IsValid()) {
+        return 1;
+    }
+
+    Shader shader("assets/shaders/instanced.vert", "assets/shaders/default.frag");
+    shader.Use();
+    GLint program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    const GLint location = glGetUniformLocation(static_cast<GLuint>(program), "ourTexture");
+    if (location == -1) {
+        std::cout << "uniform: ourTexture is not active in instanced.vert + default.frag" << std::endl;
+        return 1;
+    }
+
+    Print("glUniform1i (known location)", bench::Seconds([&] {
+        for (int i = 0; i < kIterations; ++i) {
+            glUniform1i(location, i & 7);
+        }
+    }));
+
+    StringMapLookup baseline{ static_cast<GLuint>(program), {} };
+    Print("unordered_map<string, GLint>", bench::Seconds([&] {
+        for (int i = 0; i < kIterations; ++i) {
+            glUniform1i(baseline.Get("ourTexture"), i & 7);
+        }
+    }));
+
+    Print("SetInt(const std::string&)", bench::Seconds([&] {
+        for (int i = 0; i < kIterations; ++i) {
+            shader.SetInt("ourTexture", i & 7);
+        }
+    }));
+
+    Print("SetInt(UniformHandle)", bench::Seconds([&] {
+        for (int i = 0; i < kIterations; ++i) {
+            shader.SetInt("ourTexture"_uniform, i & 7);
+        }
+    }));
+
+    glFinish();
+    glUseProgram(0);
+    return 0;
+}
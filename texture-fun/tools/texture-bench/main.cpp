@@ -0,0 +1,57 @@
+#include <SDL.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "Benchmarks.hpp"
+
+// 各項最佳化的 microbenchmark，數字都可以在本機重現。全部都是 headless，
+// 需要 OpenGL 的項目只會建立一個隱藏的視窗。必須在 texture-fun 的資料夾（有 assets 的地方）執行。
+//
+//   texture-bench [名稱]...
+//
+// 沒有指定名稱時依序執行全部。
+
+struct Entry {
+    const char* name;
+    const char* description;
+    int (*run)();
+};
+
+static const Entry kBenchmarks[] = {
+    { "decode", "decode-only throughput of TextureLoader over assets/textures", bench::Decode },
+    { "mipmap", "CPU mip chains versus glGenerateMipmap on background.png", bench::Mipmap },
+    { "defilter", "PNG decode throughput per scanline filter type", bench::Defilter },
+    { "uniform", "Shader::SetInt by string, by UniformHandle and through a string map", bench::Uniform },
+    { "matrix-stack", "MatrixStack versus the old std::stack<glm::mat4>", bench::MatrixStackOps },
+    { "matrix", "batched mat4 multiply and affine inverse versus glm over 100k matrices", bench::Matrix },
+    { "culling", "scalar frustum tests versus batched SoA culling over 4M bounds", bench::Culling },
+    { "storage", "Texture upload and bind+draw cost with immutable versus mutable storage", bench::Storage },
+};
+
+int main(int argc, char **argv) {
+    int failures = 0;
+    int matched = 0;
+    for (const Entry& entry : kBenchmarks) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc && !selected; ++i) {
+            selected = std::strcmp(argv[i], entry.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        ++matched;
+        if (entry.run() != 0) {
+            ++failures;
+        }
+    }
+
+    if (matched == 0) {
+        std::cout << "Usage: texture-bench [name]..." << std::endl;
+        for (const Entry& entry : kBenchmarks) {
+            std::cout << "  " << entry.name << ": " << entry.description << std::endl;
+        }
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BlockCompression.hpp"
+#include "CompressedImage.hpp"
+#include "Image.hpp"
+#include "Mipmap.hpp"
+#include "ThreadPool.hpp"
+#include "stb_image.h"
+
+namespace fs = std::filesystem;
+
+// 把 PNG / JPG / GIF 轉成 BC1 或 BC3 的 KTX 檔（放在來源旁邊、副檔名改成 .ktx），執行時以 texture-fun --compressed 載入。
+// GIF 的所有影格存成一個 2D array，每個影格的延遲時間記錄在 metadata 的 frame_delays_ms。
+// 每個檔案都會印出跟原圖比較的 PSNR、壓縮比，以及編碼的速度（MPixel/s，只計算 Encode 本身）。
+//
+//   texture-compress [--format auto|bc1|bc3] [--threads N] [--no-mipmaps] <檔案或資料夾>...
+//
+// auto 會在圖片有任何不透明度小於 255 的像素時選 BC3，否則選 BC1。
+
+struct Options {
+    std::string format = "auto";
+    unsigned int threads = std::thread::hardware_concurrency();
+    bool mipmaps = true;
+};
+
+struct Frame {
+    int width;
+    int height;
+    std::vector<unsigned char> rgba;
+};
+
+struct Stats {
+    double squared_error = 0.0;
+    std::size_t samples = 0;
+    double encode_seconds = 0.0;
+    std::size_t pixels = 0;
+};
+
+// 瀏覽器會把太短的延遲當成 100ms 播放，跟 AnimatedTexture 採用相同的規則
+static int NormalizeDelay(int delay_ms) {
+    return delay_ms <= 10 ? 100 : delay_ms;
+}
+
+static std::vector<unsigned char> ToRgba(const Image& image) {
+    std::size_t count = static_cast<std::size_t>(image.width) * image.height;
+    std::vector<unsigned char> rgba(count * 4);
+    const unsigned char* src = image.pixels.get();
+    for (std::size_t i = 0; i < count; ++i) {
+        const unsigned char* p = src + i * image.channels;
+        unsigned char* q = rgba.data() + i * 4;
+        if (image.channels < 3) {
+            q[0] = q[1] = q[2] = p[0];
+        } else {
+            q[0] = p[0];
+            q[1] = p[1];
+            q[2] = p[2];
+        }
+        q[3] = (image.channels == 2 || image.channels == 4) ? p[image.channels - 1] : 255;
+    }
+    return rgba;
+}
+
+static bool LoadFrames(const fs::path& path, std::vector<Frame>& frames, std::vector<int>& delays) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    if (extension == ".gif") {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        int* frame_delays = nullptr;
+        int width = 0, height = 0, count = 0, channels = 0;
+        stbi_set_flip_vertically_on_load_thread(true);
+        stbi_uc* pixels = stbi_load_gif_from_memory(buffer.data(), static_cast<int>(buffer.size()), &frame_delays, &width,
+            &height, &count, &channels, 4);
+        if (pixels == nullptr) {
+            return false;
+        }
+        std::size_t frame_size = static_cast<std::size_t>(width) * height * 4;
+        for (int i = 0; i < count; ++i) {
+            frames.push_back({ width, height, std::vector<unsigned char>(pixels + frame_size * i, pixels + frame_size * (i + 1)) });
+            delays.push_back(NormalizeDelay(frame_delays ? frame_delays[i] : 0));
+        }
+        stbi_image_free(pixels);
+        stbi_image_free(frame_delays);
+        return count > 0;
+    }
+
+    Image image(path.string());
+    if (!image.IsValid()) {
+        return false;
+    }
+    frames.push_back({ image.width, image.height, ToRgba(image) });
+    return true;
+}
+
+// 每個影格各自產生 mip chain，第 0 層就是原圖
+static std::vector<std::vector<Frame>> BuildMipChains(const std::vector<Frame>& frames, bool mipmaps) {
+    std::vector<std::vector<Frame>> chains;
+    for (const Frame& frame : frames) {
+        std::vector<Frame> chain{ frame };
+        int levels = mipmaps ? mipmap::LevelCount(frame.width, frame.height) : 1;
+        for (int level = 1; level < levels; ++level) {
+            const Frame& previous = chain.back();
+            Frame next{ std::max(1, previous.width / 2), std::max(1, previous.height / 2), {} };
+            next.rgba.resize(static_cast<std::size_t>(next.width) * next.height * 4);
+            mipmap::Downsample(previous.rgba.data(), previous.width, previous.height, 4, next.rgba.data(), MipmapFilter::SrgbBox);
+            chain.push_back(std::move(next));
+        }
+        chains.push_back(std::move(chain));
+    }
+    return chains;
+}
+
+// 解壓縮回來跟原圖比較，RGB 一律計算，BC3 另外加上 alpha
+static void Measure(bcn::Format format, const Frame& frame, const unsigned char* blocks, Stats& stats) {
+    std::vector<unsigned char> decoded(frame.rgba.size());
+    bcn::Decode(format, blocks, frame.width, frame.height, decoded.data());
+    int channels = format == bcn::Format::Bc3 ? 4 : 3;
+    for (std::size_t i = 0; i < decoded.size(); i += 4) {
+        for (int c = 0; c < channels; ++c) {
+            double d = static_cast<double>(frame.rgba[i + c]) - decoded[i + c];
+            stats.squared_error += d * d;
+        }
+        stats.samples += static_cast<std::size_t>(channels);
+    }
+}
+
+static bool Compress(const fs::path& path, const Options& options, ThreadPool& pool) {
+    std::vector<Frame> frames;
+    std::vector<int> delays;
+    if (!LoadFrames(path, frames, delays)) {
+        std::cout << "Failed to load " << path.string() << std::endl;
+        return false;
+    }
+
+    bool has_alpha = false;
+    for (const Frame& frame : frames) {
+        for (std::size_t i = 3; i < frame.rgba.size() && !has_alpha; i += 4) {
+            has_alpha = frame.rgba[i] < 255;
+        }
+    }
+    bcn::Format format = options.format == "bc1" ? bcn::Format::Bc1
+                       : options.format == "bc3" ? bcn::Format::Bc3
+                       : has_alpha                ? bcn::Format::Bc3
+                                                  : bcn::Format::Bc1;
+
+    std::vector<std::vector<Frame>> chains = BuildMipChains(frames, options.mipmaps);
+    const std::size_t layers = frames.size();
+
+    CompressedImage output;
+    output.internal_format = format == bcn::Format::Bc1 ? compressed_format::Bc1 : compressed_format::Bc3;
+    output.base_format = format == bcn::Format::Bc1 ? 0x1907 : 0x1908;  // GL_RGB、GL_RGBA
+    output.width = frames[0].width;
+    output.height = frames[0].height;
+    output.layers = delays.empty() ? 0 : static_cast<int>(layers);
+    if (!delays.empty()) {
+        std::string text;
+        for (int delay : delays) {
+            text += (text.empty() ? "" : ",") + std::to_string(delay);
+        }
+        output.metadata["frame_delays_ms"] = text;
+    }
+
+    Stats stats;
+    std::size_t source_bytes = 0;
+    for (std::size_t level = 0; level < chains[0].size(); ++level) {
+        const Frame& first = chains[0][level];
+        std::size_t layer_size = bcn::CompressedSize(format, first.width, first.height);
+        std::shared_ptr<unsigned char> data(new unsigned char[layer_size * layers], std::default_delete<unsigned char[]>());
+        for (std::size_t layer = 0; layer < layers; ++layer) {
+            const Frame& frame = chains[layer][level];
+            unsigned char* blocks = data.get() + layer_size * layer;
+
+            auto start = std::chrono::steady_clock::now();
+            bcn::Encode(format, frame.rgba.data(), frame.width, frame.height, blocks, &pool);
+            stats.encode_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            stats.pixels += static_cast<std::size_t>(frame.width) * frame.height;
+            source_bytes += frame.rgba.size();
+
+            Measure(format, frame, blocks, stats);
+        }
+        output.levels.push_back({ first.width, first.height, layer_size * layers, data });
+    }
+
+    fs::path destination = path;
+    destination.replace_extension(".ktx");
+    if (!output.Save(destination.string())) {
+        return false;
+    }
+
+    std::size_t compressed_bytes = 0;
+    for (const CompressedImage::Level& level : output.levels) {
+        compressed_bytes += level.size;
+    }
+    double mse = stats.squared_error / std::max<std::size_t>(1, stats.samples);
+    double psnr = mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+    double throughput = stats.encode_seconds > 0.0 ? stats.pixels / stats.encode_seconds / 1.0e6 : 0.0;
+    std::cout << path.string() << " -> " << destination.filename().string() << ": "
+              << (format == bcn::Format::Bc1 ? "BC1" : "BC3") << ", " << output.width << "x" << output.height
+              << (layers > 1 ? " x " + std::to_string(layers) + " layers" : "") << ", " << output.levels.size() << " levels, "
+              << std::fixed << std::setprecision(2) << "PSNR " << psnr << " dB" << (format == bcn::Format::Bc3 ? " (RGBA)" : " (RGB)")
+              << ", " << static_cast<double>(source_bytes) / compressed_bytes << ":1 vs RGBA8, " << throughput << " MPixel/s"
+              << std::defaultfloat << std::endl;
+    return true;
+}
+
+static bool IsSourceImage(const fs::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".gif";
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    std::vector<fs::path> inputs;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            options.format = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--no-mipmaps") == 0) {
+            options.mipmaps = false;
+        } else {
+            inputs.emplace_back(argv[i]);
+        }
+    }
+    if (inputs.empty() || (options.format != "auto" && options.format != "bc1" && options.format != "bc3")) {
+        std::cout << "Usage: texture-compress [--format auto|bc1|bc3] [--threads N] [--no-mipmaps] <file or directory>..." << std::endl;
+        return 1;
+    }
+
+    // 資料夾會遞迴找出所有圖片，依路徑排序，輸出的順序才會固定
+    std::vector<fs::path> files;
+    for (const fs::path& input : inputs) {
+        if (fs::is_directory(input)) {
+            for (const auto& entry : fs::recursive_directory_iterator(input)) {
+                if (entry.is_regular_file() && IsSourceImage(entry.path())) {
+                    files.push_back(entry.path());
+                }
+            }
+        } else {
+            files.push_back(input);
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    ThreadPool pool(std::max(1u, options.threads));
+    int failures = 0;
+    for (const fs::path& file : files) {
+        if (!Compress(file, options, pool)) {
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -11,6 +11,13 @@
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 
 #ifdef __APPLE__
 #include <GLUT/glut.h>
@@ -23,12 +30,52 @@ static bool show_demo_window = true;
 static float fovy = 45.0f;
 static std::vector<bool> key_state = std::vector<bool>(512, false);
 
+// Headless mode: --headless, --frames N, --dump DIR, --dump-every N
+static bool headless = false;
+static int max_frames = 0;
+static std::string dump_directory;
+static int dump_every = 1;
+static int frame_count = 0;
+
 // Time unit
 long last_time = 0;
 float delta_time = 0.0;
 
 unsigned int RickRollTexture;
 
+// Headless frames go into a framebuffer object instead of the hidden window's back buffer, whose contents
+// are undefined for pixels the window system considers obscured. GL 1.x headers don't declare the FBO
+// entry points, so they are looked up through glutGetProcAddress (freeglut only).
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_RENDERBUFFER 0x8D41
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+#define GL_DEPTH_COMPONENT24 0x81A6
+#endif
+
+struct FramebufferFunctions {
+    void (APIENTRY *GenFramebuffers)(GLsizei, GLuint*);
+    void (APIENTRY *DeleteFramebuffers)(GLsizei, const GLuint*);
+    void (APIENTRY *BindFramebuffer)(GLenum, GLuint);
+    GLenum (APIENTRY *CheckFramebufferStatus)(GLenum);
+    void (APIENTRY *GenRenderbuffers)(GLsizei, GLuint*);
+    void (APIENTRY *DeleteRenderbuffers)(GLsizei, const GLuint*);
+    void (APIENTRY *BindRenderbuffer)(GLenum, GLuint);
+    void (APIENTRY *RenderbufferStorage)(GLenum, GLenum, GLsizei, GLsizei);
+    void (APIENTRY *FramebufferRenderbuffer)(GLenum, GLenum, GLenum, GLuint);
+};
+
+static FramebufferFunctions fbo_functions = {};
+static GLuint headless_framebuffer = 0;
+static GLuint headless_renderbuffers[2] = { 0, 0 };
+
 struct Camera {
     glm::vec3 position;
     glm::vec3 velocity;
@@ -120,7 +167,11 @@ static unsigned int loadTexture(const std::string& file) {
                 break;
         }
 
+        // stb_image rows are tightly packed; an RGB image whose width is not a multiple of 4
+        // would be read skewed with the default 4-byte unpack alignment
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
         glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, image);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     } else {
         std::cout << "Failed to load texture" << std::endl;
         exit(-42069);
@@ -242,7 +293,131 @@ static void drawFloor() {
     glEnd();
 }
 
-static void display() {
+// ImGui's Framerate is a running average, so headless runs report the distribution of per-frame times
+// instead (nearest-rank percentiles, the first frame is skipped since it includes texture upload).
+static void printFrameTimes(const std::vector<double>& frame_times) {
+    if (frame_times.size() <= 1) {
+        return;
+    }
+
+    std::vector<double> sorted(frame_times.begin() + 1, frame_times.end());
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    };
+    std::cout << "Frame time (" << sorted.size() << " frames): p50 " << percentile(0.50) << " ms, p95 "
+              << percentile(0.95) << " ms, p99 " << percentile(0.99) << " ms, max " << sorted.back() << " ms"
+              << std::endl;
+}
+
+static void parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            max_frames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dump_directory = argv[++i];
+        } else if (std::strcmp(argv[i], "--dump-every") == 0 && i + 1 < argc) {
+            dump_every = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+
+    // headless without --frames renders a single frame, so it always terminates on CI.
+    if (headless && max_frames <= 0) {
+        max_frames = 1;
+    }
+}
+
+// Read the rendered frame and save it as a binary PPM (P6), flipping rows since OpenGL's origin is bottom-left.
+static void dumpFrame(int frame) {
+    if (dump_directory.empty() || frame % dump_every != 0) {
+        return;
+    }
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(window_width) * window_height * 3);
+    glReadBuffer(headless_framebuffer != 0 ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, window_width, window_height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    std::filesystem::create_directories(dump_directory);
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%05d.ppm", frame);
+    std::string file_path = (std::filesystem::path(dump_directory) / name).string();
+    std::ofstream file(file_path, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to write " << file_path << std::endl;
+        return;
+    }
+
+    file << "P6\n" << window_width << " " << window_height << "\n255\n";
+    const size_t row_size = static_cast<size_t>(window_width) * 3;
+    for (int y = window_height - 1; y >= 0; --y) {
+        file.write(reinterpret_cast<const char*>(pixels.data() + y * row_size), row_size);
+    }
+}
+
+template <typename Function>
+static bool loadProc(Function& function, const char* name) {
+#ifdef __FREEGLUT_EXT_H__
+    function = reinterpret_cast<Function>(glutGetProcAddress(name));
+#else
+    (void)name;
+    function = nullptr;
+#endif
+    return function != nullptr;
+}
+
+// Create an RGBA8 + depth framebuffer of the window size and bind it; returns false when the context has no
+// FBO support, in which case frames are rendered into the back buffer as before.
+static bool createHeadlessFramebuffer() {
+    FramebufferFunctions& f = fbo_functions;
+    bool loaded = loadProc(f.GenFramebuffers, "glGenFramebuffers") && loadProc(f.DeleteFramebuffers, "glDeleteFramebuffers") &&
+                  loadProc(f.BindFramebuffer, "glBindFramebuffer") &&
+                  loadProc(f.CheckFramebufferStatus, "glCheckFramebufferStatus") &&
+                  loadProc(f.GenRenderbuffers, "glGenRenderbuffers") &&
+                  loadProc(f.DeleteRenderbuffers, "glDeleteRenderbuffers") &&
+                  loadProc(f.BindRenderbuffer, "glBindRenderbuffer") &&
+                  loadProc(f.RenderbufferStorage, "glRenderbufferStorage") &&
+                  loadProc(f.FramebufferRenderbuffer, "glFramebufferRenderbuffer");
+    if (!loaded) {
+        return false;
+    }
+
+    f.GenRenderbuffers(2, headless_renderbuffers);
+    f.BindRenderbuffer(GL_RENDERBUFFER, headless_renderbuffers[0]);
+    f.RenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, window_width, window_height);
+    f.BindRenderbuffer(GL_RENDERBUFFER, headless_renderbuffers[1]);
+    f.RenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, window_width, window_height);
+    f.BindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    f.GenFramebuffers(1, &headless_framebuffer);
+    f.BindFramebuffer(GL_FRAMEBUFFER, headless_framebuffer);
+    f.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, headless_renderbuffers[0]);
+    f.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, headless_renderbuffers[1]);
+    if (f.CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        f.BindFramebuffer(GL_FRAMEBUFFER, 0);
+        f.DeleteFramebuffers(1, &headless_framebuffer);
+        f.DeleteRenderbuffers(2, headless_renderbuffers);
+        headless_framebuffer = 0;
+        return false;
+    }
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    return true;
+}
+
+static void destroyHeadlessFramebuffer() {
+    if (headless_framebuffer == 0) {
+        return;
+    }
+    fbo_functions.BindFramebuffer(GL_FRAMEBUFFER, 0);
+    fbo_functions.DeleteFramebuffers(1, &headless_framebuffer);
+    fbo_functions.DeleteRenderbuffers(2, headless_renderbuffers);
+    headless_framebuffer = 0;
+}
+
+static void renderFrame() {
     // Start the Dear ImGui frame
     ImGui_ImplOpenGL2_NewFrame();
     ImGui_ImplGLUT_NewFrame();
@@ -277,9 +452,23 @@ static void display() {
     // glutSolidTeapot(0.5);
 
     ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+}
+
+static void display() {
+    renderFrame();
+    dumpFrame(frame_count);
 
     glutSwapBuffers();
     glutPostRedisplay();
+
+    ++frame_count;
+    if (max_frames > 0 && frame_count >= max_frames) {
+#ifdef __FREEGLUT_EXT_H__
+        glutLeaveMainLoop();
+#else
+        exit(0);
+#endif
+    }
 }
 
 void idle(void) {
@@ -291,8 +480,9 @@ void idle(void) {
 }
 
 int main(int argc, char** argv) {
-    // GLUT window initialization
+    // GLUT window initialization (glutInit removes the arguments it understands)
     glutInit(&argc, argv);
+    parseArguments(argc, argv);
 #ifdef __FREEGLUT_EXT_H__
     glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
 #endif
@@ -332,7 +522,41 @@ int main(int argc, char** argv) {
     // Gen Texture
     genTextures();
 
-    glutMainLoop();
+    if (headless) {
+        // The window only provides the GL context (on GPU-less Linux, run under Xvfb with llvmpipe). Frames
+        // are rendered into an FBO and never swapped, so vsync doesn't apply.
+        glutHideWindow();
+        ImGui::GetIO().DisplaySize = ImVec2(static_cast<float>(window_width), static_cast<float>(window_height));
+        if (!createHeadlessFramebuffer()) {
+            std::cout << "Could not create a framebuffer object, rendering into the back buffer" << std::endl;
+        }
+
+        // The loop below drives rendering itself; glutMainLoopEvent would otherwise also run display() and
+        // idle() and render extra (or swap away) frames. freeglut rejects a NULL display callback.
+        glutDisplayFunc([] {});
+        glutIdleFunc(nullptr);
+
+        std::vector<double> frame_times;
+        auto start = std::chrono::steady_clock::now();
+        for (frame_count = 0; frame_count < max_frames; ++frame_count) {
+            auto frame_start = std::chrono::steady_clock::now();
+#ifdef __FREEGLUT_EXT_H__
+            glutMainLoopEvent();
+#endif
+            renderFrame();
+            dumpFrame(frame_count);
+            glFinish();
+            frame_times.push_back(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_start).count());
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Rendered " << max_frames << " frames in " << elapsed << " ms (" << elapsed / max_frames
+                  << " ms/frame)" << std::endl;
+        printFrameTimes(frame_times);
+        destroyHeadlessFramebuffer();
+    } else {
+        glutMainLoop();
+    }
 
     // Cleanup
     ImGui_ImplOpenGL2_Shutdown();
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+// 無視窗（headless）模式：視窗隱藏、關閉 vsync，畫面畫在自己的 framebuffer object 上，
+// 跑完固定的 frame 數後結束，並且可以把畫面存成 PPM。沒有 GPU 的 Linux 可以搭配 llvmpipe 與
+// SDL_VIDEODRIVER=offscreen（SDL 2.0.12 以上，走 EGL）或 Xvfb 執行。
+namespace offscreen {
+    struct Options
+    {
+        bool headless = false;
+        int frames = 0;           // 0 代表一直跑到視窗關閉
+        std::string dumpDirectory; // 空字串代表不存圖
+        int dumpEvery = 1;
+    };
+
+    // --headless、--frames N、--dump DIR、--dump-every N
+    Options parseArguments(int argc, char** argv);
+
+    struct Target
+    {
+        GLuint framebuffer = 0;
+        GLuint color = 0;
+        GLuint depth = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    Target createTarget(int width, int height);
+    void deleteTarget(Target& target);
+
+    // 讀取目前綁定的 framebuffer，存成 dumpDirectory/frame_NNNNN.ppm（如果這個 frame 需要存的話）
+    void dumpFrame(Options const& options, int frameIndex, int width, int height);
+}
@@ -0,0 +1,124 @@
+#include "Offscreen.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace offscreen::details
+{
+    bool writePpm(std::string const& filepath, int width, int height)
+    {
+        std::vector<unsigned char> pixels(static_cast<std::size_t>(width) * height * 3);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+        std::ofstream file(filepath, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        // OpenGL 的原點在左下角，PPM 是從最上面一列開始存
+        file << "P6\n" << width << " " << height << "\n255\n";
+        std::size_t const rowSize = static_cast<std::size_t>(width) * 3;
+        for (int y = height - 1; y >= 0; --y)
+        {
+            file.write(reinterpret_cast<char const*>(pixels.data() + y * rowSize), rowSize);
+        }
+        return static_cast<bool>(file);
+    }
+}
+
+namespace offscreen
+{
+    Options parseArguments(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--headless") == 0)
+            {
+                options.headless = true;
+            }
+            else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            {
+                options.frames = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc)
+            {
+                options.dumpDirectory = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--dump-every") == 0 && i + 1 < argc)
+            {
+                options.dumpEvery = std::max(1, std::atoi(argv[++i]));
+            }
+        }
+
+        // headless 又沒有指定 frame 數的話就只跑一張，避免在 CI 上永遠不會結束
+        if (options.headless && options.frames <= 0)
+        {
+            options.frames = 1;
+        }
+        return options;
+    }
+
+    Target createTarget(int width, int height)
+    {
+        Target target;
+        target.width = width;
+        target.height = height;
+
+        glGenRenderbuffers(1, &target.color);
+        glBindRenderbuffer(GL_RENDERBUFFER, target.color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+        glGenRenderbuffers(1, &target.depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, target.depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+        glGenFramebuffers(1, &target.framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.color);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depth);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cerr << "[Error] Offscreen framebuffer is incomplete" << std::endl;
+            exit(-1);
+        }
+        return target;
+    }
+
+    void deleteTarget(Target& target)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &target.framebuffer);
+        glDeleteRenderbuffers(1, &target.color);
+        glDeleteRenderbuffers(1, &target.depth);
+        target = Target {};
+    }
+
+    void dumpFrame(Options const& options, int frameIndex, int width, int height)
+    {
+        if (options.dumpDirectory.empty() || frameIndex % options.dumpEvery != 0)
+        {
+            return;
+        }
+
+        std::filesystem::create_directories(options.dumpDirectory);
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%05d.ppm", frameIndex);
+        std::string filepath = (std::filesystem::path(options.dumpDirectory) / name).string();
+        if (!details::writePpm(filepath, width, height))
+        {
+            std::cerr << "[Error] Failed to write " << filepath << std::endl;
+        }
+    }
+}
@@ -7,6 +7,8 @@
 namespace shader {
     GLuint createProgram();
     void deleteProgram(GLuint programId);
+    // attachShader 只讀取原始碼，實際的編譯延後到 linkProgram；
+    // 同樣的原始碼與 driver 之前 link 過的話，linkProgram 會直接從 .cache/shaders 載入 program binary
     void attachShader(GLuint programId, GLenum shaderType, std::string const& filepath);
     void linkProgram(GLuint programId);
 }
@@ -2,9 +2,16 @@
 
 #include <glad/glad.h>
 
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace shader::details
 {
@@ -48,13 +55,160 @@ namespace shader::details
 
         return false;
     }
+
+    // attachShader 只先記下原始碼，等到 linkProgram 時才決定要編譯還是載入快取的 program binary
+    std::unordered_map<GLuint, std::vector<std::pair<GLenum, std::string>>> pendingSources;
+
+    constexpr char const* cacheDirectory = ".cache/shaders";
+    constexpr char cacheMagic[4] = {'P', 'R', 'G', 'B'};
+
+    struct CacheHeader
+    {
+        char magic[4];
+        std::uint64_t key;
+        std::uint32_t format;
+        std::uint32_t length;
+    };
+
+    std::uint64_t fnv1a(void const* data, std::size_t size, std::uint64_t seed = 14695981039346656037ull)
+    {
+        auto bytes = static_cast<unsigned char const*>(data);
+        std::uint64_t value = seed;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ull;
+        }
+        return value;
+    }
+
+    bool supportsProgramBinary()
+    {
+        bool supported = false;
+#if defined(GL_VERSION_4_1)
+        supported = supported || GLAD_GL_VERSION_4_1;
+#endif
+#if defined(GL_ARB_get_program_binary)
+        supported = supported || GLAD_GL_ARB_get_program_binary;
+#endif
+        GLint formats = 0;
+        if (supported)
+        {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        }
+        return formats > 0;
+    }
+
+    // key 包含所有原始碼以及 driver 的 vendor / renderer / version，任何一個改變都會重新編譯
+    std::uint64_t cacheKey(std::vector<std::pair<GLenum, std::string>> const& sources)
+    {
+        std::uint64_t key = fnv1a(cacheMagic, sizeof(cacheMagic));
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+        {
+            auto text = reinterpret_cast<char const*>(glGetString(name));
+            key = fnv1a(text, text ? std::strlen(text) + 1 : 0, key);
+        }
+        for (auto const& [type, source] : sources)
+        {
+            std::uint64_t length = source.size();
+            key = fnv1a(&type, sizeof(type), key);
+            key = fnv1a(&length, sizeof(length), key);
+            key = fnv1a(source.data(), source.size(), key);
+        }
+        return key;
+    }
+
+    std::string cachePath(std::uint64_t key)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return (std::filesystem::path(cacheDirectory) / name).string();
+    }
+
+    bool loadProgramBinary(GLuint programId, std::uint64_t key)
+    {
+        std::ifstream file(cachePath(key), std::ios::binary);
+        CacheHeader header;
+        if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.key != key)
+        {
+            return false;
+        }
+
+        std::vector<char> binary(header.length);
+        if (!file.read(binary.data(), binary.size()))
+        {
+            return false;
+        }
+
+        // driver 拒絕這份 binary（例如 driver 更新過）時安靜地退回一般的編譯流程
+        glProgramBinary(programId, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint success;
+        glGetProgramiv(programId, GL_LINK_STATUS, &success);
+        return success == GL_TRUE;
+    }
+
+    void storeProgramBinary(GLuint programId, std::uint64_t key)
+    {
+        GLint length = 0;
+        glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+        {
+            return;
+        }
+
+        CacheHeader header;
+        std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+        header.key = key;
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(programId, length, &length, &format, binary.data());
+        header.format = format;
+        header.length = static_cast<std::uint32_t>(length);
+
+        std::error_code error;
+        std::filesystem::create_directories(cacheDirectory, error);
+        std::string path = cachePath(key);
+        {
+            std::ofstream file(path + ".tmp", std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return;
+            }
+            file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+            file.write(binary.data(), header.length);
+        }
+        std::filesystem::rename(path + ".tmp", path, error);
+    }
+
+    bool compileAndAttach(GLuint programId, GLenum shaderType, std::string const& source)
+    {
+        char const* const shaderSourceArray[1] = {source.c_str()};
+
+        GLuint shaderObject = glCreateShader(shaderType);
+        glShaderSource(shaderObject, 1, shaderSourceArray, nullptr);
+        glCompileShader(shaderObject);
+
+        bool compiled = isCompiled(shaderObject);
+        if (compiled)
+        {
+            glAttachShader(programId, shaderObject);
+        }
+
+        glDeleteShader(shaderObject);
+        return compiled;
+    }
 }
 
 namespace shader
 {
     GLuint createProgram() { return glCreateProgram(); }
 
-    void deleteProgram(GLuint programId) { glDeleteProgram(programId); }
+    void deleteProgram(GLuint programId)
+    {
+        details::pendingSources.erase(programId);
+        glDeleteProgram(programId);
+    }
 
     void attachShader(GLuint programId, GLenum shaderType, std::string const& filepath)
     {
@@ -72,26 +226,45 @@ namespace shader
         file.read(source.data(), source.size());
         file.close();
 
-        char const* const shaderSourceArray[1] = {source.c_str()};
+        details::pendingSources[programId].emplace_back(shaderType, std::move(source));
+    }
 
-        GLuint shaderObject = glCreateShader(shaderType);
-        glShaderSource(shaderObject, 1, shaderSourceArray, nullptr);
-        glCompileShader(shaderObject);
+    void linkProgram(GLuint programId)
+    {
+        using namespace std::chrono;
 
-        if (details::isCompiled(shaderObject))
+        auto start = steady_clock::now();
+        auto sources = std::move(details::pendingSources[programId]);
+        details::pendingSources.erase(programId);
+
+        bool useCache = details::supportsProgramBinary();
+        std::uint64_t key = details::cacheKey(sources);
+        if (useCache && details::loadProgramBinary(programId, key))
         {
-            glAttachShader(programId, shaderObject);
+            auto elapsed = duration<double, std::milli>(steady_clock::now() - start).count();
+            std::cout << "[Info] Shader program loaded from the program binary cache in " << elapsed << " ms" << std::endl;
+            return;
         }
 
-        glDeleteShader(shaderObject);
-    }
+        for (auto const& [type, source] : sources)
+        {
+            details::compileAndAttach(programId, type, source);
+        }
+        if (useCache)
+        {
+            glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
 
-    void linkProgram(GLuint programId)
-    {
         glLinkProgram(programId);
         if (details::isLinked(programId))
         {
-            std::cout << "[Info] Shader objects have been successfully linked into the program!" << std::endl;
+            auto elapsed = duration<double, std::milli>(steady_clock::now() - start).count();
+            std::cout << "[Info] Shader objects have been successfully linked into the program in " << elapsed << " ms"
+                      << std::endl;
+            if (useCache)
+            {
+                details::storeProgramBinary(programId, key);
+            }
         }
         else
         {
@@ -1,9 +1,11 @@
+#include "Offscreen.hpp"
 #include "Shader.hpp"
 
 #include <glad/glad.h>
 #include <SDL.h>
 #include "stb_image.h"
 
+#include <chrono>
 #include <iostream>
 #include <vector>
 
@@ -24,6 +26,7 @@ static std::vector<unsigned int> indices = {
 };
 
 int main(int argc, char **argv) {
+    auto const options = offscreen::parseArguments(argc, argv);
 
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         std::cout << "SDL_Init Error: " << SDL_GetError() << std::endl;
@@ -34,7 +37,9 @@ int main(int argc, char **argv) {
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
 
-    auto const flags = SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI;
+    // headless 時視窗只是用來建立 OpenGL context，不會顯示出來
+    auto const flags = SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI |
+                       (options.headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
     SDL_Window *window = SDL_CreateWindow("Texture Example: SDL2 with stb_image", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, window_width, window_height, flags);
     if (window == nullptr) {
         std::cout << "SDL_CreateWindow Error: " << SDL_GetError() << std::endl;
@@ -45,7 +50,7 @@ int main(int argc, char **argv) {
     SDL_SetWindowMinimumSize(window, 400, 300);
     auto glContext = SDL_GL_CreateContext(window);
     SDL_GL_MakeCurrent(window, glContext);
-    SDL_GL_SetSwapInterval(1);
+    SDL_GL_SetSwapInterval(options.headless ? 0 : 1);
 
     gladLoadGLLoader(SDL_GL_GetProcAddress);
 
@@ -117,7 +122,10 @@ int main(int argc, char **argv) {
                 break;
         }
 
+        // stb_image 的每列之間沒有 padding，寬度不是 4 的倍數的 RGB 圖片必須改成以 1 byte 對齊，否則畫面會歪掉
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
         glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, image);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
         glGenerateMipmap(GL_TEXTURE_2D);
     } else {
         std::cout << "Failed to load texture" << std::endl;
@@ -125,7 +133,15 @@ int main(int argc, char **argv) {
     }
     stbi_image_free(image);
 
+    // headless 時改畫在 FBO 上，隱藏視窗的 default framebuffer 內容是未定義的
+    offscreen::Target target;
+    if (options.headless) {
+        target = offscreen::createTarget(window_width, window_height);
+    }
+
     bool isDone = false;
+    int frame = 0;
+    auto const start = std::chrono::steady_clock::now();
 
     while (!isDone) {
         SDL_Event event;
@@ -158,7 +174,26 @@ int main(int argc, char **argv) {
         glBindVertexArray(vao);
         glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
 
-        SDL_GL_SwapWindow(window);
+        offscreen::dumpFrame(options, frame, window_width, window_height);
+        if (options.headless) {
+            glFinish();
+        } else {
+            SDL_GL_SwapWindow(window);
+        }
+
+        ++frame;
+        if (options.frames > 0 && frame >= options.frames) {
+            isDone = true;
+        }
+    }
+
+    if (options.frames > 0) {
+        auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Rendered " << frame << " frames in " << elapsed << " ms (" << elapsed / frame << " ms/frame)"
+                  << std::endl;
+    }
+    if (options.headless) {
+        offscreen::deleteTarget(target);
     }
 
     SDL_DestroyWindow(window);